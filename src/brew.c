@@ -267,6 +267,7 @@ int BREW_fstat(IFile *fd, struct stat *buf)
 
   ret = IFILE_GetInfo(fd, &pInfo);
   buf->st_size = pInfo.dwSize;
+  buf->st_mtime = pInfo.dwCreationDate;
 
   return (ret) ? -ret : ret;
 }
@@ -9,9 +9,34 @@
 #include "AEEFile.h"
 #include "prboom.h"
 
-void BREW_Blit(void *fb, int width, int height, int depth)
+#define BLIT_TEX_WIDTH  512
+#define BLIT_TEX_HEIGHT 256
+
+unsigned int BREW_BlitBytes = 0;
+
+static boolean texture_ready = false;
+
+static void BREW_UploadRows(const unsigned char *fb, int top, int count, int depth)
+{
+  glTexSubImage2D(
+      GL_TEXTURE_2D,
+      0,
+      0,
+      top,
+      BLIT_TEX_WIDTH,
+      count,
+      GL_RGB,
+      GL_UNSIGNED_SHORT_5_6_5,
+      fb + top * BLIT_TEX_WIDTH * depth
+  );
+
+  BREW_BlitBytes += count * BLIT_TEX_WIDTH * depth;
+}
+
+void BREW_Blit(void *fb, int width, int height, int depth, unsigned char *dirtyrows)
 {
   GLenum err = GL_NO_ERROR;
+  int y, top;
 
   GLint pScreenCoords[5] = {
       (int)((640 / 2) - (640 / 2)),
@@ -22,17 +47,53 @@ void BREW_Blit(void *fb, int width, int height, int depth)
 
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  glTexImage2D(
-      GL_TEXTURE_2D,
-      0,
-      GL_RGB,
-      512,
-      256,
-      0,
-      GL_RGB,
-      GL_UNSIGNED_SHORT_5_6_5,
-      fb
-  );
+  if (height > BLIT_TEX_HEIGHT)
+    height = BLIT_TEX_HEIGHT;
+
+  BREW_BlitBytes = 0;
+
+  if (!texture_ready)
+  {
+    // allocate the texture storage once, rows are filled in below
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RGB,
+        BLIT_TEX_WIDTH,
+        BLIT_TEX_HEIGHT,
+        0,
+        GL_RGB,
+        GL_UNSIGNED_SHORT_5_6_5,
+        NULL
+    );
+    texture_ready = true;
+
+    if (dirtyrows)
+      BREW_memset(dirtyrows, 1, height);
+  }
+
+  if (!dirtyrows)
+  {
+    BREW_UploadRows(fb, 0, height, depth);
+  }
+  else
+  {
+    // upload each run of consecutive dirty rows as one band
+    for (y = 0; y < height; )
+    {
+      if (!dirtyrows[y])
+      {
+        y++;
+        continue;
+      }
+
+      top = y;
+      while (y < height && dirtyrows[y])
+        dirtyrows[y++] = 0;
+
+      BREW_UploadRows(fb, top, y - top, depth);
+    }
+  }
 
   pApp->glDrawTexivOES(pScreenCoords);
 
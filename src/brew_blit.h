@@ -6,6 +6,12 @@
 #ifndef __BREW_BLIT__
 #define __BREW_BLIT__
 
-void BREW_Blit(void *fb, int width, int height, int depth);
+// Uploads fb to the display texture and presents it. If dirtyrows is
+// not NULL only the marked rows are uploaded and their marks cleared,
+// otherwise all rows are uploaded.
+void BREW_Blit(void *fb, int width, int height, int depth, unsigned char *dirtyrows);
+
+// Bytes uploaded to the display texture by the last BREW_Blit
+extern unsigned int BREW_BlitBytes;
 
 #endif
@@ -74,6 +74,8 @@
 #include "d_deh.h"  // Ty 04/08/98 - Externalizations
 #include "lprintf.h"  // jff 08/03/98 - declaration of lprintf
 #include "am_map.h"
+#include "m_bench.h"
+#include "m_memstats.h"
 #include "brew.h"
 #include "prboom.h"
 
@@ -212,6 +214,8 @@ void D_Display (void)
   if (!I_StartDisplay())
     return;
 
+  M_BENCH_START(BP_FRAME);
+
   // save the current screen if about to wipe
   if ((wipe = gamestate != wipegamestate) && (V_GetMode() != VID_MODEGL))
     wipe_StartScreen();
@@ -272,7 +276,9 @@ void D_Display (void)
       R_RenderPlayerView (&players[displayplayer]);
     if (automapmode & am_active)
       AM_Drawer();
+    M_BENCH_START(BP_STATUSBAR);
     ST_Drawer((viewheight != SCREENHEIGHT) || ((automapmode & am_active) && !(automapmode & am_overlay)), redrawborderstuff);
+    M_BENCH_END(BP_STATUSBAR);
     if (V_GetMode() != VID_MODEGL)
       R_DrawViewBorder();
     HU_Drawer();
@@ -298,14 +304,18 @@ void D_Display (void)
 #endif
 
   // normal update
-  if (!wipe || (V_GetMode() == VID_MODEGL))
+  if (!wipe || (V_GetMode() == VID_MODEGL)) {
+    M_BENCH_START(BP_FINISHUPDATE);
     I_FinishUpdate ();              // page flip or blit buffer
-  else {
+    M_BENCH_END(BP_FINISHUPDATE);
+  } else {
     // wipe update
     wipe_EndScreen();
     D_Wipe();
   }
 
+  M_BENCH_END(BP_FRAME);
+
   I_EndDisplay();
 
   //e6y: don't thrash cpu during pausing
@@ -371,6 +381,9 @@ static void D_DoomLoop(void)
         D_Display();
       }
 
+      // read queued lumps while the frame is on screen
+      W_ServiceQueue();
+
       // CPhipps - auto screenshot
       if (auto_shot_fname && !--auto_shot_count) {
   auto_shot_count = auto_shot_time;
@@ -421,6 +434,9 @@ void D_BrewDoomLoop(void)
     D_Display();
   }
 
+  // read queued lumps while the frame is on screen
+  W_ServiceQueue();
+
   // CPhipps - auto screenshot
   if (auto_shot_fname && !--auto_shot_count) {
     auto_shot_count = auto_shot_time;
@@ -1386,6 +1402,9 @@ static void D_DoomMainSetup(void)
   nodrawers = M_CheckParm ("-nodraw");
   noblit = M_CheckParm ("-noblit");
 
+  // -memhud, -memstats: heap telemetry overlay and log
+  M_MemStatsInit();
+
   //proff 11/22/98: Added setting of viewangleoffset
   p = M_CheckParm("-viewangle");
   if (p)
@@ -1668,6 +1687,11 @@ static void D_DoomMainSetup(void)
   timingdemo = true;            // show stats after quit
   G_DeferedPlayDemo(myargv[p]);
   singledemo = true;            // quit after one demo
+  // per-phase frame timings, written out when the demo ends
+  if ((p = M_CheckParm("-benchreport")) && ++p < myargc)
+    M_BenchInit(myargv[p]);
+  else
+    M_BenchInit("timedemo.csv");
       }
     else
       if ((p = M_CheckParm("-playdemo")) && ++p < myargc)
@@ -72,6 +72,8 @@ typedef union
 typedef actionf_t  think_t;
 
 
+struct block_memory_alloc_s;
+
 /* Doubly linked list of actors. */
 typedef struct thinker_s
 {
@@ -89,6 +91,11 @@ typedef struct thinker_s
    * this one using pointers. Used for garbage collection.
    */
   unsigned references;
+
+  /* Block memory zone the thinker came from, NULL if Z_Malloc'ed,
+   * so P_FreeThinker can return it without searching the zones.
+   */
+  struct block_memory_alloc_s *zone;
 } thinker_t;
 
 #endif
@@ -193,6 +193,8 @@ int wipe_ScreenWipe(int ticks)
       wipe_scr = screens[0];
       wipe_initMelt(ticks);
     }
+  // the melt writes straight into the frame buffer
+  V_MarkRect(0, 0, SCREENWIDTH, SCREENHEIGHT);
   // do a piece of wipe-in
   if (wipe_doMelt(ticks))     // final stuff
     {
@@ -82,6 +82,8 @@
 #include "i_system.h"
 #include "r_demo.h"
 #include "r_fps.h"
+#include "m_bench.h"
+#include "m_memstats.h"
 #include "brew.h"
 
 #define SAVEGAMESIZE  0x20000
@@ -610,9 +612,37 @@ static void G_DoLoadLevel (void)
   // by Z_FreeTags() when the previous level ended or player
   // died.
 
+  // The mobj and sector special pools went the same way; report how
+  // full they got during the level that ended before forgetting them,
+  // along with how the sight checks of that level were answered.
   {
     DECLARE_BLOCK_MEMORY_ALLOC_ZONE(secnodezone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(ceilingzone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(doorzone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(floorzone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(platzone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(glowzone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(strobezone);
+    DECLARE_BLOCK_MEMORY_ALLOC_ZONE(scrollzone);
+    Z_BLogStats(&secnodezone);
+    Z_BLogStats(&mobjzone);
+    Z_BLogStats(&ceilingzone);
+    Z_BLogStats(&doorzone);
+    Z_BLogStats(&floorzone);
+    Z_BLogStats(&platzone);
+    Z_BLogStats(&glowzone);
+    Z_BLogStats(&strobezone);
+    Z_BLogStats(&scrollzone);
+    P_LogSightStats();
     NULL_BLOCK_MEMORY_ALLOC_ZONE(secnodezone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(mobjzone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(ceilingzone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(doorzone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(floorzone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(platzone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(glowzone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(strobezone);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(scrollzone);
       //extern msecnode_t *headsecnode; // phares 3/25/98
       //headsecnode = NULL;
   }
@@ -956,6 +986,8 @@ void G_Ticker (void)
       D_PageTicker ();
       break;
     }
+
+  M_MemStatsTicker ();
 }
 
 //
@@ -1558,7 +1590,9 @@ static const struct {
    *  the file format is unchanged. */
   { prboom_3_compatibility, "PrBoom %d", 210},
   { prboom_5_compatibility, "PrBoom %d", 211},
-  { prboom_6_compatibility, "PrBoom %d", 212}
+  /* thinker_t gained a zone pointer, so thinkers saved before are a
+   * word short and 212 savegames can't be read */
+  { prboom_6_compatibility, "PrBoom %d", 213}
 };
 
 static const size_t num_version_headers = sizeof(version_headers) / sizeof(version_headers[0]);
@@ -2928,6 +2962,7 @@ boolean G_CheckDemoStatus (void)
       int endtime = I_GetTime_RealTime ();
       // killough -- added fps information and made it work for longer demos:
       unsigned realtics = endtime-starttime;
+      M_BenchReport((unsigned) gametic, realtics);
       I_Error ("Timed %u gametics in %u realtics = %-.1f frames per second",
                (unsigned) gametic,realtics,
                (unsigned) gametic * (double) TICRATE / realtics);
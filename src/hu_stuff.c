@@ -44,6 +44,7 @@
 #include "d_deh.h"   /* Ty 03/27/98 - externalization of mapnamesx arrays */
 #include "g_game.h"
 #include "r_main.h"
+#include "m_memstats.h"
 
 // global heads up display controls
 
@@ -126,6 +127,10 @@ int hud_graph_keys=1; //jff 3/7/98 display HUD keys as graphics
 #define HU_INPUTWIDTH 64
 #define HU_INPUTHEIGHT  1
 
+// heap telemetry overlay, below the message and chat lines
+#define HU_MEMSTATSX 2
+#define HU_MEMSTATSY (HU_INPUTY + 2*hu_font[0].height)
+
 #define key_alt KEYD_RALT
 #define key_shift KEYD_RSHIFT
 
@@ -182,6 +187,7 @@ static hu_textline_t  w_weapon; //jff 2/16/98 new weapon widget for hud
 static hu_textline_t  w_keys;   //jff 2/16/98 new keys widget for hud
 static hu_textline_t  w_gkeys;  //jff 3/7/98 graphic keys widget for hud
 static hu_textline_t  w_monsec; //jff 2/16/98 new kill/secret widget for hud
+static hu_textline_t  w_memstats[MEMSTATS_LINES]; // -memhud overlay
 static hu_mtext_t     w_rtext;  //jff 2/26/98 text message refresh widget
 
 static boolean    always_off = false;
@@ -614,6 +620,18 @@ void HU_Start(void)
       HUlib_addCharToTextLine(&w_coordz, *(s++));
   }
 
+  // create the heap telemetry overlay, filled in by HU_Drawer
+  for (i = 0; i < MEMSTATS_LINES; i++)
+    HUlib_initTextLine
+    (
+      &w_memstats[i],
+      HU_MEMSTATSX,
+      HU_MEMSTATSY + i*HU_GAPY,
+      hu_font,
+      HU_FONTSTART,
+      hudcolor_xyco
+    );
+
   //jff 2/16/98 initialize ammo widget
   strcpy(hud_ammostr,"AMM ");
   s = hud_ammostr;
@@ -1256,6 +1274,19 @@ void HU_Drawer(void)
   HU_Erase(); // jff 4/24/98 Erase current lines before drawing current
               // needed when screen not fullsize
 
+  // heap telemetry overlay, the text is refreshed by M_MemStatsTicker
+  if (memstats_hud)
+  {
+    for (i = 0; i < MEMSTATS_LINES; i++)
+    {
+      HUlib_clearTextLine(&w_memstats[i]);
+      s = memstats_text[i];
+      while (*s)
+        HUlib_addCharToTextLine(&w_memstats[i], *(s++));
+      HUlib_drawTextLine(&w_memstats[i], false);
+    }
+  }
+
   //jff 4/21/98 if setup has disabled message list while active, turn it off
   if (hud_msg_lines<=1)
     message_list = false;
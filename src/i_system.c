@@ -107,6 +107,14 @@ int I_GetTime_RealTime (void)
   return i;
 }
 
+/* I_GetTime_MS
+ * Millisecond clock, used for profiling
+ */
+unsigned int I_GetTime_MS(void)
+{
+  return BREW_GetTicks();
+}
+
 #ifndef PRBOOM_SERVER
 fixed_t I_GetTimeFrac (void)
 {
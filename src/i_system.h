@@ -44,6 +44,7 @@ extern int ms_to_next_tick;
 boolean I_StartDisplay(void);
 void I_EndDisplay(void);
 int I_GetTime_RealTime(void);     /* killough */
+unsigned int I_GetTime_MS(void);
 #ifndef PRBOOM_SERVER
 fixed_t I_GetTimeFrac (void);
 #endif
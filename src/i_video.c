@@ -70,6 +70,7 @@ int use_doublebuffer = 1; // Included not to break m_misc, but not relevant to S
 #endif
 int use_fullscreen;
 int desired_fullscreen;
+int use_dirtyblit = 1; // upload only the screen rows that changed
 
 ////////////////////////////////////////////////////////////////////////////
 // Input code
@@ -350,6 +351,9 @@ void I_UpdateNoBlit (void)
 static int newpal = 0;
 #define NO_PALETTE_CHANGE 1000
 
+// -blitstats: report the average texture upload size once a second
+static boolean blitstats;
+
 void I_FinishUpdate (void)
 {
   if (I_SkipFrame()) return;
@@ -399,8 +403,19 @@ void I_FinishUpdate (void)
   // printf("screens[0].width = %u", screens[0].width);
   // printf("screens[0].height = %u", screens[0].height);
   // printf("screens[0].depth = %u", V_GetModePixelDepth(V_GetMode()));
-  BREW_Blit(screens[0].data, screens[0].width, screens[0].height, V_GetModePixelDepth(V_GetMode()));
+  BREW_Blit(screens[0].data, screens[0].width, screens[0].height, V_GetModePixelDepth(V_GetMode()),
+            use_dirtyblit ? V_DirtyRows : NULL);
   //printf("after Brew blit");
+
+  if (blitstats) {
+    static unsigned int frames, bytes;
+
+    bytes += BREW_BlitBytes;
+    if (++frames == TICRATE) {
+      lprintf(LO_INFO, "I_FinishUpdate: %u bytes/frame uploaded\n", bytes / frames);
+      frames = bytes = 0;
+    }
+  }
 }
 
 //
@@ -667,6 +682,8 @@ void I_UpdateVideoMode(void)
 
   mouse_currently_grabbed = false;
 
+  blitstats = M_CheckParm("-blitstats") != 0;
+
 //   // Get the info needed to render to the display
 //   if (!SDL_MUSTLOCK(screen))
 //   {
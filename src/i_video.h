@@ -78,5 +78,6 @@ void I_StartFrame (void);
 extern int use_doublebuffer;  /* proff 2001-7-4 - controls wether to use doublebuffering*/
 extern int use_fullscreen;  /* proff 21/05/2000 */
 extern int desired_fullscreen; //e6y
+extern int use_dirtyblit;
 
 #endif
@@ -0,0 +1,164 @@
+/*
+ *  SPDX-FileCopyrightText: Copyright 2012-2023 Fausto "O3" Ribeiro | OpenZeebo <zeebo@tripleoxygen.net>
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Per-phase frame timing for -timedemo benchmark runs.
+//
+// Each phase keeps a histogram of its per-frame time in milliseconds,
+// from which the percentiles are read when the demo ends. Phases that
+// run more than once in a frame are summed for that frame.
+//
+// Report format (CSV, two tables separated by a blank line):
+//
+//   gametics,realtics,fps
+//   <tics>,<tics>,<fps>
+//
+//   phase,frames,total_ms,mean_ms,p50_ms,p95_ms,p99_ms,max_ms
+//   frame,...
+//   bsp,...
+
+#include <stdarg.h>
+
+#include "m_bench.h"
+#include "doomdef.h"
+#include "m_fixed.h"
+#include "i_system.h"
+#include "lprintf.h"
+
+#define BENCH_BUCKETS 256 // 1ms buckets, the last one collects the rest
+
+typedef struct {
+  const char *name;
+  unsigned int start;
+  unsigned int frametime;
+  unsigned int frames;
+  unsigned int total;
+  unsigned int max;
+  unsigned int histogram[BENCH_BUCKETS];
+} benchstat_t;
+
+boolean benchmarking = false;
+
+static const char *benchfile;
+
+static benchstat_t benchstats[NUMBENCHPHASES] = {
+  {"frame"},
+  {"bsp"},
+  {"planes"},
+  {"masked"},
+  {"statusbar"},
+  {"finishupdate"},
+};
+
+void M_BenchInit(const char *reportfile)
+{
+  benchfile = reportfile;
+  benchmarking = true;
+  lprintf(LO_INFO, "M_BenchInit: writing frame timings to %s\n", benchfile);
+}
+
+void M_BenchPhaseStart(benchphase_t phase)
+{
+  benchstats[phase].start = I_GetTime_MS();
+}
+
+void M_BenchPhaseEnd(benchphase_t phase)
+{
+  benchstat_t *stat = &benchstats[phase];
+
+  stat->frametime += I_GetTime_MS() - stat->start;
+
+  // the frame phase encloses all others, so closing it closes the frame
+  if (phase == BP_FRAME)
+  {
+    int i;
+
+    for (i = 0; i < NUMBENCHPHASES; i++)
+    {
+      unsigned int t = benchstats[i].frametime;
+
+      benchstats[i].frames++;
+      benchstats[i].total += t;
+      if (t > benchstats[i].max)
+        benchstats[i].max = t;
+      benchstats[i].histogram[t < BENCH_BUCKETS ? t : BENCH_BUCKETS-1]++;
+      benchstats[i].frametime = 0;
+    }
+  }
+}
+
+//
+// M_BenchPercentile
+// Returns the smallest bucket holding at least pct percent of the frames
+//
+static unsigned int M_BenchPercentile(const benchstat_t *stat, int pct)
+{
+  unsigned int want = (stat->frames * pct + 99) / 100;
+  unsigned int seen = 0;
+  int i;
+
+  for (i = 0; i < BENCH_BUCKETS; i++)
+  {
+    seen += stat->histogram[i];
+    if (seen >= want)
+      return i;
+  }
+  return BENCH_BUCKETS-1;
+}
+
+// BREW has no fprintf, format first and write the bytes
+static void M_BenchWrite(FILE *f, const char *format, ...)
+{
+  char line[128];
+  va_list args;
+  int len;
+
+  va_start(args, format);
+  len = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  if (len > 0)
+    fwrite(line, 1, len < (int)sizeof(line) ? len : (int)sizeof(line) - 1, f);
+}
+
+void M_BenchReport(unsigned int gametics, unsigned int realtics)
+{
+  FILE *f;
+  uint_64_t fps;
+  int i;
+
+  if (!benchmarking)
+    return;
+
+  if (!(f = fopen(benchfile, "w")))
+  {
+    lprintf(LO_WARN, "M_BenchReport: unable to open %s\n", benchfile);
+    return;
+  }
+
+  // in hundredths, BREW's vsnprintf has no floating point
+  fps = realtics ? (uint_64_t)gametics * TICRATE * 100 / realtics : 0;
+
+  M_BenchWrite(f, "gametics,realtics,fps\n");
+  M_BenchWrite(f, "%u,%u,%u.%02u\n\n", gametics, realtics,
+          (unsigned)(fps / 100), (unsigned)(fps % 100));
+
+  M_BenchWrite(f, "phase,frames,total_ms,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n");
+  for (i = 0; i < NUMBENCHPHASES; i++)
+  {
+    const benchstat_t *stat = &benchstats[i];
+    unsigned int mean = stat->frames ?
+      (unsigned)((uint_64_t)stat->total * 100 / stat->frames) : 0;
+
+    M_BenchWrite(f, "%s,%u,%u,%u.%02u,%u,%u,%u,%u\n",
+            stat->name, stat->frames, stat->total,
+            mean / 100, mean % 100,
+            M_BenchPercentile(stat, 50),
+            M_BenchPercentile(stat, 95),
+            M_BenchPercentile(stat, 99),
+            stat->max);
+  }
+
+  fclose(f);
+}
@@ -0,0 +1,36 @@
+/*
+ *  SPDX-FileCopyrightText: Copyright 2012-2023 Fausto "O3" Ribeiro | OpenZeebo <zeebo@tripleoxygen.net>
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Per-phase frame timing for -timedemo benchmark runs
+
+#ifndef __M_BENCH__
+#define __M_BENCH__
+
+#include "doomtype.h"
+
+typedef enum {
+  BP_FRAME,         // whole D_Display call
+  BP_BSP,           // R_RenderBSPNode
+  BP_PLANES,        // R_DrawPlanes
+  BP_MASKED,        // R_DrawMasked
+  BP_STATUSBAR,     // ST_Drawer
+  BP_FINISHUPDATE,  // I_FinishUpdate
+  NUMBENCHPHASES
+} benchphase_t;
+
+extern boolean benchmarking;
+
+void M_BenchInit(const char *reportfile);
+void M_BenchPhaseStart(benchphase_t phase);
+void M_BenchPhaseEnd(benchphase_t phase);
+void M_BenchReport(unsigned int gametics, unsigned int realtics);
+
+// Cheap enough to leave in the hot paths when not benchmarking
+#define M_BENCH_START(phase) \
+  do { if (benchmarking) M_BenchPhaseStart(phase); } while (0)
+#define M_BENCH_END(phase) \
+  do { if (benchmarking) M_BenchPhaseEnd(phase); } while (0)
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ *  SPDX-FileCopyrightText: Copyright 2012-2023 Fausto "O3" Ribeiro | OpenZeebo <zeebo@tripleoxygen.net>
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Heap telemetry, sampled once a second from the counters z_zone.c and
+// the lump cache keep in every build, so memory pressure can be watched
+// on the device before Z_Malloc runs out.
+//
+// -memhud shows the figures over the game view. -memstats [file] appends
+// them to a CSV log (memstats.csv by default), one row per second:
+//
+//   tic,footprint,peak,static,sound,music,level,levspec,cache,
+//   allocs_per_tic,frees_per_tic,lump_hits,lump_misses,cache_purges
+//
+// Byte figures are in bytes, rates are averaged over the last second.
+
+#include "m_memstats.h"
+#include "doomdef.h"
+#include "doomstat.h"
+#include "m_argv.h"
+#include "w_wad.h"
+#include "z_zone.h"
+#include "lprintf.h"
+#include "brew.h"
+
+boolean memstats_hud = false;
+char memstats_text[MEMSTATS_LINES][40];
+
+static FILE *memstats_log;
+
+void M_MemStatsInit(void)
+{
+  int p;
+
+  memstats_hud = M_CheckParm("-memhud") != 0;
+
+  if ((p = M_CheckParm("-memstats")))
+  {
+    const char *logfile = "memstats.csv";
+    static const char header[] =
+      "tic,footprint,peak,static,sound,music,level,levspec,cache,"
+      "allocs_per_tic,frees_per_tic,lump_hits,lump_misses,cache_purges\n";
+
+    if (p < myargc - 1 && *myargv[p + 1] != '-')
+      logfile = myargv[p + 1];
+    if (!(memstats_log = fopen(logfile, "w")))
+      lprintf(LO_WARN, "M_MemStatsInit: unable to open %s\n", logfile);
+    else
+    {
+      fwrite(header, 1, sizeof(header) - 1, memstats_log);
+      lprintf(LO_INFO, "M_MemStatsInit: logging heap statistics to %s\n", logfile);
+    }
+  }
+}
+
+void M_MemStatsTicker(void)
+{
+  static unsigned int tics, lastallocs, lastfrees, lasthits, lastmisses;
+  const size_t *tagbytes = zonestats.tagbytes;
+  unsigned int allocs, frees, hits, misses, lookups;
+
+  if ((!memstats_hud && !memstats_log) || ++tics < TICRATE)
+    return;
+
+  allocs = zonestats.allocs - lastallocs;
+  frees = zonestats.frees - lastfrees;
+  hits = W_CacheHits - lasthits;
+  misses = W_CacheMisses - lastmisses;
+  lookups = hits + misses;
+
+  if (memstats_hud)
+  {
+    snprintf(memstats_text[0], sizeof(memstats_text[0]), "HEAP %uK PEAK %uK",
+             (unsigned)(zonestats.footprint >> 10),
+             (unsigned)(zonestats.peakfootprint >> 10));
+    snprintf(memstats_text[1], sizeof(memstats_text[1]), "STATIC %uK LEVEL %uK SPEC %uK",
+             (unsigned)(tagbytes[PU_STATIC] >> 10),
+             (unsigned)(tagbytes[PU_LEVEL] >> 10),
+             (unsigned)(tagbytes[PU_LEVSPEC] >> 10));
+    snprintf(memstats_text[2], sizeof(memstats_text[2]), "CACHE %uK SOUND %uK MUSIC %uK",
+             (unsigned)(tagbytes[PU_CACHE] >> 10),
+             (unsigned)(tagbytes[PU_SOUND] >> 10),
+             (unsigned)(tagbytes[PU_MUSIC] >> 10));
+    snprintf(memstats_text[3], sizeof(memstats_text[3]), "ALLOC %u.%u/T FREE %u.%u/T",
+             allocs / TICRATE, allocs * 10 / TICRATE % 10,
+             frees / TICRATE, frees * 10 / TICRATE % 10);
+    snprintf(memstats_text[4], sizeof(memstats_text[4]), "LUMP HITS %u%% MISSES %u PURGES %d",
+             lookups ? hits * 100 / lookups : 100, misses,
+             zonestats.cachepurges);
+  }
+
+  if (memstats_log)
+  {
+    char row[160];
+    int len;
+
+    // BREW has no fprintf, format first and write the bytes
+    len = snprintf(row, sizeof(row), "%d,%u,%u,%u,%u,%u,%u,%u,%u,%u.%02u,%u.%02u,%u,%u,%d\n",
+                   gametic,
+                   (unsigned)zonestats.footprint, (unsigned)zonestats.peakfootprint,
+                   (unsigned)tagbytes[PU_STATIC], (unsigned)tagbytes[PU_SOUND],
+                   (unsigned)tagbytes[PU_MUSIC], (unsigned)tagbytes[PU_LEVEL],
+                   (unsigned)tagbytes[PU_LEVSPEC], (unsigned)tagbytes[PU_CACHE],
+                   allocs / TICRATE, allocs * 100 / TICRATE % 100,
+                   frees / TICRATE, frees * 100 / TICRATE % 100,
+                   hits, misses, zonestats.cachepurges);
+    if (len > 0)
+      fwrite(row, 1, len < (int)sizeof(row) ? len : (int)sizeof(row) - 1, memstats_log);
+  }
+
+  tics = 0;
+  lastallocs = zonestats.allocs;
+  lastfrees = zonestats.frees;
+  lasthits = W_CacheHits;
+  lastmisses = W_CacheMisses;
+}
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: Copyright 2012-2023 Fausto "O3" Ribeiro | OpenZeebo <zeebo@tripleoxygen.net>
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Heap telemetry: -memhud overlay and -memstats CSV log
+
+#ifndef __M_MEMSTATS__
+#define __M_MEMSTATS__
+
+#include "doomtype.h"
+
+#define MEMSTATS_LINES 5
+
+extern boolean memstats_hud;
+
+// Overlay text, refreshed once a second by M_MemStatsTicker
+extern char memstats_text[MEMSTATS_LINES][40];
+
+void M_MemStatsInit(void);
+void M_MemStatsTicker(void);
+
+#endif
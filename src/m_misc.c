@@ -69,6 +69,7 @@
 #include "r_draw.h"
 #include "r_demo.h"
 #include "r_fps.h"
+#include "r_segs.h"
 #include "brew.h"
 
 /* cph - disk icon not implemented */
@@ -200,6 +201,8 @@ default_t defaults[] =
    def_hex, ss_none}, // 0, +1 for colours, +2 for non-ascii chars, +4 for skip-last-line
   {"level_precache",{(int*)&precache},{0},0,1,
    def_bool,ss_none}, // precache level data?
+  {"lumpcache_budget",{&lumpcache_budget},{0},0,UL,
+   def_int,ss_none}, // kilobytes of unlocked lumps kept cached, 0 = no limit
   {"demo_smoothturns", {&demo_smoothturns},  {0},0,1,
    def_bool,ss_stat},
   {"demo_smoothturnsfactor", {&demo_smoothturnsfactor},  {6},1,SMOOTH_PLAYING_MAXFACTOR,
@@ -329,6 +332,10 @@ default_t defaults[] =
   {"use_doublebuffer",{&use_doublebuffer},{1},0,1,             // proff 2001-7-4
    def_bool,ss_none}, // enable doublebuffer to avoid display tearing (fullscreen)
 #endif
+  {"use_dirtyblit",{&use_dirtyblit},{1},0,1,
+   def_bool,ss_none}, // only upload the screen rows changed since the last frame
+  {"render_fastwalls",{&render_fastwalls},{1},0,1,
+   def_bool,ss_none}, // division-free wall setup, off for vanilla compatibility levels
   {"translucency",{&default_translucency},{1},0,1,   // phares
    def_bool,ss_none}, // enables translucency
   {"tran_filter_pct",{&tran_filter_pct},{66},0,100,         // killough 2/21/98
@@ -0,0 +1,116 @@
+/*
+ *  SPDX-FileCopyrightText: Copyright 2012-2023 Fausto "O3" Ribeiro | OpenZeebo <zeebo@tripleoxygen.net>
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Headless replacement for brew_blit.c, selected with VIDEO=null. The
+// app is then built without EGL and GLES (see NULL_VIDEO in prboom.c),
+// so -timedemo on the device times the renderer without the texture
+// upload and buffer swap. Frames rendered into screens[0] are discarded,
+// hashed (-framehash [file]) or streamed raw to a file (-framedump
+// <file>) to check renderer changes for regressions.
+
+#include "brew_blit.h"
+#include "doomdef.h"
+#include "m_argv.h"
+#include "md5.h"
+#include "lprintf.h"
+#include "brew.h"
+
+unsigned int BREW_BlitBytes = 0;
+
+static boolean sink_ready = false;
+static boolean framehash = false;
+static FILE *hashfile = NULL;
+static FILE *dumpfile = NULL;
+static unsigned int framenum = 0;
+
+static void NULL_InitSink(void)
+{
+  int p;
+
+  sink_ready = true;
+
+  if ((p = M_CheckParm("-framehash")))
+  {
+    framehash = true;
+    if (p < myargc - 1 && *myargv[p + 1] != '-')
+    {
+      if (!(hashfile = fopen(myargv[p + 1], "wb")))
+        lprintf(LO_WARN, "NULL_InitSink: unable to open %s\n", myargv[p + 1]);
+    }
+  }
+
+  if ((p = M_CheckParm("-framedump")) && p < myargc - 1)
+  {
+    if (!(dumpfile = fopen(myargv[p + 1], "wb")))
+      lprintf(LO_WARN, "NULL_InitSink: unable to open %s\n", myargv[p + 1]);
+  }
+}
+
+static void NULL_HashFrame(const unsigned char *fb, int width, int height, int depth)
+{
+  struct MD5Context md5;
+  unsigned char digest[16];
+  char hex[33];
+  int y, i;
+
+  MD5Init(&md5);
+  for (y = 0; y < height; y++)
+    MD5Update(&md5, fb + y * SCREENPITCH, width * depth);
+  MD5Final(digest, &md5);
+
+  for (i = 0; i < 16; i++)
+    sprintf(hex + i * 2, "%02x", digest[i]);
+
+  if (hashfile)
+  {
+    // BREW has no fprintf, format first and write the bytes
+    char line[48];
+    int len = snprintf(line, sizeof(line), "%u %s\n", framenum, hex);
+
+    if (len > 0)
+      fwrite(line, 1, len < (int)sizeof(line) ? len : (int)sizeof(line) - 1, hashfile);
+  }
+  else
+    lprintf(LO_INFO, "frame %u %s\n", framenum, hex);
+}
+
+static void NULL_DumpFrame(const unsigned char *fb, int width, int height, int depth)
+{
+  int y;
+
+  // rows are written unpadded, frames back to back; every fwrite is a
+  // file system call, so a frame without padding goes in one
+  if (width * depth == SCREENPITCH)
+    fwrite(fb, 1, height * SCREENPITCH, dumpfile);
+  else
+    for (y = 0; y < height; y++)
+      fwrite(fb + y * SCREENPITCH, 1, width * depth, dumpfile);
+}
+
+void BREW_Blit(void *fb, int width, int height, int depth, unsigned char *dirtyrows)
+{
+  int y;
+
+  if (!sink_ready)
+    NULL_InitSink();
+
+  // account for what the device would have uploaded, so -blitstats
+  // reports the same figures as on the real backend
+  BREW_BlitBytes = 0;
+  for (y = 0; y < height; y++)
+  {
+    if (!dirtyrows || dirtyrows[y])
+      BREW_BlitBytes += SCREENPITCH;
+  }
+  if (dirtyrows)
+    memset(dirtyrows, 0, height);
+
+  if (framehash)
+    NULL_HashFrame(fb, width, height, depth);
+  if (dumpfile)
+    NULL_DumpFrame(fb, width, height, depth);
+
+  framenum++;
+}
@@ -38,6 +38,8 @@
 #include "s_sound.h"
 #include "sounds.h"
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(ceilingzone, sizeof(ceiling_t), PU_LEVSPEC, 16, "Ceilings");
+
 // the list of ceilings moving currently, including crushers
 ceilinglist_t *activeceilings;
 
@@ -279,9 +281,9 @@ int EV_DoCeiling
 
     // create a new ceiling thinker
     rtn = 1;
-    ceiling = Z_Malloc (sizeof(*ceiling), PU_LEVSPEC, 0);
+    ceiling = Z_BMalloc(&ceilingzone);
     memset(ceiling, 0, sizeof(*ceiling));
-    P_AddThinker (&ceiling->thinker);
+    P_AddPooledThinker (&ceiling->thinker, &ceilingzone);
     sec->ceilingdata = ceiling;               //jff 2/22/98
     ceiling->thinker.function = T_MoveCeiling;
     ceiling->sector = sec;
@@ -41,6 +41,8 @@
 #include "d_deh.h"  // Ty 03/27/98 - externalized
 #include "lprintf.h"
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(doorzone, sizeof(vldoor_t), PU_LEVSPEC, 16, "Doors");
+
 ///////////////////////////////////////////////////////////////
 //
 // Door action routines, called once per tick
@@ -371,9 +373,9 @@ int EV_DoDoor
 
     // new door thinker
     rtn = 1;
-    door = Z_Malloc (sizeof(*door), PU_LEVSPEC, 0);
+    door = Z_BMalloc(&doorzone);
     memset(door, 0, sizeof(*door));
-    P_AddThinker (&door->thinker);
+    P_AddPooledThinker (&door->thinker, &doorzone);
     sec->ceilingdata = door; //jff 2/22/98
 
     door->thinker.function = T_VerticalDoor;
@@ -585,9 +587,9 @@ int EV_VerticalDoor
   }
 
   // new door thinker
-  door = Z_Malloc (sizeof(*door), PU_LEVSPEC, 0);
+  door = Z_BMalloc(&doorzone);
   memset(door, 0, sizeof(*door));
-  P_AddThinker (&door->thinker);
+  P_AddPooledThinker (&door->thinker, &doorzone);
   sec->ceilingdata = door; //jff 2/22/98
   door->thinker.function = T_VerticalDoor;
   door->sector = sec;
@@ -657,10 +659,10 @@ void P_SpawnDoorCloseIn30 (sector_t* sec)
 {
   vldoor_t* door;
 
-  door = Z_Malloc ( sizeof(*door), PU_LEVSPEC, 0);
+  door = Z_BMalloc(&doorzone);
 
   memset(door, 0, sizeof(*door));
-  P_AddThinker (&door->thinker);
+  P_AddPooledThinker (&door->thinker, &doorzone);
 
   sec->ceilingdata = door; //jff 2/22/98
   sec->special = 0;
@@ -689,10 +691,10 @@ void P_SpawnDoorRaiseIn5Mins
 {
   vldoor_t* door;
 
-  door = Z_Malloc ( sizeof(*door), PU_LEVSPEC, 0);
+  door = Z_BMalloc(&doorzone);
 
   memset(door, 0, sizeof(*door));
-  P_AddThinker (&door->thinker);
+  P_AddPooledThinker (&door->thinker, &doorzone);
 
   sec->ceilingdata = door; //jff 2/22/98
   sec->special = 0;
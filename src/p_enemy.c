@@ -97,21 +97,17 @@ static void P_RecursiveSound(sector_t *sec, int soundblocks,
   sec->soundtraversed = soundblocks+1;
   P_SetTarget(&sec->soundtarget, soundtarget);
 
-  for (i=0; i<sec->linecount; i++)
+  // only the two-sided lines, see P_BuildSectorGraph
+  for (i=0; i<sec->soundlinecount; i++)
     {
-      sector_t *other;
-      line_t *check = sec->lines[i];
-
-      if (!(check->flags & ML_TWOSIDED))
-        continue;
+      sector_t *other = &sectors[sec->soundlines[i].other];
+      line_t *check = sec->soundlines[i].line;
 
       P_LineOpening(check);
 
       if (openrange <= 0)
         continue;       // closed door
 
-      other=sides[check->sidenum[sides[check->sidenum[0]].sector==sec]].sector;
-
       if (!(check->flags & ML_SOUNDBLOCK))
         P_RecursiveSound(other, soundblocks, soundtarget);
       else
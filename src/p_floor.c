@@ -40,6 +40,8 @@
 #include "s_sound.h"
 #include "sounds.h"
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(floorzone, sizeof(floormove_t), PU_LEVSPEC, 16, "Floors");
+
 ///////////////////////////////////////////////////////////////////////
 //
 // Plane (floor or ceiling), Floor motion and Elevator action routines
@@ -62,7 +64,7 @@
 //  pastdest - plane moved normally and is now at destination height
 //  crushed - plane encountered an obstacle, is holding until removed
 //
-result_e T_MovePlane
+static result_e P_MovePlane
 ( sector_t*     sector,
   fixed_t       speed,
   fixed_t       dest,
@@ -219,6 +221,25 @@ result_e T_MovePlane
   return ok;
 }
 
+result_e T_MovePlane
+( sector_t*     sector,
+  fixed_t       speed,
+  fixed_t       dest,
+  boolean       crush,
+  int           floorOrCeiling,
+  int           direction )
+{
+  result_e      res;
+
+  // Sight checks run by the actions of things crushed on the way see
+  // heights the move may take back, so cached ones go both before and
+  // after it
+  P_InvalidateSightCache();
+  res = P_MovePlane(sector, speed, dest, crush, floorOrCeiling, direction);
+  P_InvalidateSightCache();
+  return res;
+}
+
 //
 // T_MoveFloor()
 //
@@ -444,9 +465,9 @@ int EV_DoFloor
 
     // new floor thinker
     rtn = 1;
-    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+    floor = Z_BMalloc(&floorzone);
     memset(floor, 0, sizeof(*floor));
-    P_AddThinker (&floor->thinker);
+    P_AddPooledThinker (&floor->thinker, &floorzone);
     sec->floordata = floor; //jff 2/22/98
     floor->thinker.function = T_MoveFloor;
     floor->type = floortype;
@@ -748,9 +769,9 @@ int EV_BuildStairs
 
     // create new floor thinker for first step
     rtn = 1;
-    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+    floor = Z_BMalloc(&floorzone);
     memset(floor, 0, sizeof(*floor));
-    P_AddThinker (&floor->thinker);
+    P_AddPooledThinker (&floor->thinker, &floorzone);
     sec->floordata = floor;
     floor->thinker.function = T_MoveFloor;
     floor->direction = 1;
@@ -829,9 +850,9 @@ int EV_BuildStairs
         secnum = newsecnum;
 
         // create and initialize a thinker for the next step
-        floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+        floor = Z_BMalloc(&floorzone);
         memset(floor, 0, sizeof(*floor));
-        P_AddThinker (&floor->thinker);
+        P_AddPooledThinker (&floor->thinker, &floorzone);
 
         sec->floordata = floor; //jff 2/22/98
         floor->thinker.function = T_MoveFloor;
@@ -927,9 +948,9 @@ int EV_DoDonut(line_t*  line)
       s3 = s2->lines[i]->backsector;      // s3 is model sector for changes
 
       //  Spawn rising slime
-      floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+      floor = Z_BMalloc(&floorzone);
       memset(floor, 0, sizeof(*floor));
-      P_AddThinker (&floor->thinker);
+      P_AddPooledThinker (&floor->thinker, &floorzone);
       s2->floordata = floor; //jff 2/22/98
       floor->thinker.function = T_MoveFloor;
       floor->type = donutRaise;
@@ -942,9 +963,9 @@ int EV_DoDonut(line_t*  line)
       floor->floordestheight = s3->floorheight;
 
       //  Spawn lowering donut-hole pillar
-      floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+      floor = Z_BMalloc(&floorzone);
       memset(floor, 0, sizeof(*floor));
-      P_AddThinker (&floor->thinker);
+      P_AddPooledThinker (&floor->thinker, &floorzone);
       s1->floordata = floor; //jff 2/22/98
       floor->thinker.function = T_MoveFloor;
       floor->type = lowerFloor;
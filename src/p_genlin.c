@@ -108,9 +108,9 @@ manual_floor:
 
     // new floor thinker
     rtn = 1;
-    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+    floor = Z_BMalloc(&floorzone);
     memset(floor, 0, sizeof(*floor));
-    P_AddThinker (&floor->thinker);
+    P_AddPooledThinker (&floor->thinker, &floorzone);
     sec->floordata = floor;
     floor->thinker.function = T_MoveFloor;
     floor->crush = Crsh;
@@ -312,9 +312,9 @@ manual_ceiling:
 
     // new ceiling thinker
     rtn = 1;
-    ceiling = Z_Malloc (sizeof(*ceiling), PU_LEVSPEC, 0);
+    ceiling = Z_BMalloc(&ceilingzone);
     memset(ceiling, 0, sizeof(*ceiling));
-    P_AddThinker (&ceiling->thinker);
+    P_AddPooledThinker (&ceiling->thinker, &ceilingzone);
     sec->ceilingdata = ceiling; //jff 2/22/98
     ceiling->thinker.function = T_MoveCeiling;
     ceiling->crush = Crsh;
@@ -519,9 +519,9 @@ manual_lift:
 
     // Setup the plat thinker
     rtn = 1;
-    plat = Z_Malloc( sizeof(*plat), PU_LEVSPEC, 0);
+    plat = Z_BMalloc(&platzone);
     memset(plat, 0, sizeof(*plat));
-    P_AddThinker(&plat->thinker);
+    P_AddPooledThinker(&plat->thinker, &platzone);
 
     plat->sector = sec;
     plat->sector->floordata = plat;
@@ -680,9 +680,9 @@ manual_stair:
 
     // new floor thinker
     rtn = 1;
-    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+    floor = Z_BMalloc(&floorzone);
     memset(floor, 0, sizeof(*floor));
-    P_AddThinker (&floor->thinker);
+    P_AddPooledThinker (&floor->thinker, &floorzone);
     sec->floordata = floor;
     floor->thinker.function = T_MoveFloor;
     floor->direction = Dirn? 1 : -1;
@@ -781,10 +781,10 @@ manual_stair:
 
         sec = tsec;
         secnum = newsecnum;
-        floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+        floor = Z_BMalloc(&floorzone);
 
         memset(floor, 0, sizeof(*floor));
-        P_AddThinker (&floor->thinker);
+        P_AddPooledThinker (&floor->thinker, &floorzone);
 
         sec->floordata = floor;
         floor->thinker.function = T_MoveFloor;
@@ -866,9 +866,9 @@ manual_crusher:
 
     // new ceiling thinker
     rtn = 1;
-    ceiling = Z_Malloc (sizeof(*ceiling), PU_LEVSPEC, 0);
+    ceiling = Z_BMalloc(&ceilingzone);
     memset(ceiling, 0, sizeof(*ceiling));
-    P_AddThinker (&ceiling->thinker);
+    P_AddPooledThinker (&ceiling->thinker, &ceilingzone);
     sec->ceilingdata = ceiling; //jff 2/22/98
     ceiling->thinker.function = T_MoveCeiling;
     ceiling->crush = true;
@@ -962,9 +962,9 @@ manual_locked:
 
     // new door thinker
     rtn = 1;
-    door = Z_Malloc (sizeof(*door), PU_LEVSPEC, 0);
+    door = Z_BMalloc(&doorzone);
     memset(door, 0, sizeof(*door));
-    P_AddThinker (&door->thinker);
+    P_AddPooledThinker (&door->thinker, &doorzone);
     sec->ceilingdata = door; //jff 2/22/98
 
     door->thinker.function = T_VerticalDoor;
@@ -1072,9 +1072,9 @@ manual_door:
 
     // new door thinker
     rtn = 1;
-    door = Z_Malloc (sizeof(*door), PU_LEVSPEC, 0);
+    door = Z_BMalloc(&doorzone);
     memset(door, 0, sizeof(*door));
-    P_AddThinker (&door->thinker);
+    P_AddPooledThinker (&door->thinker, &doorzone);
     sec->ceilingdata = door; //jff 2/22/98
 
     door->thinker.function = T_VerticalDoor;
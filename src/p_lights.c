@@ -40,6 +40,9 @@
 #include "p_spec.h"
 #include "p_tick.h"
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(glowzone, sizeof(glow_t), PU_LEVSPEC, 32, "Glows");
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(strobezone, sizeof(strobe_t), PU_LEVSPEC, 32, "Strobes");
+
 //////////////////////////////////////////////////////////
 //
 // Lighting action routines, called once per tick
@@ -241,10 +244,10 @@ void P_SpawnStrobeFlash
 {
   strobe_t* flash;
 
-  flash = Z_Malloc ( sizeof(*flash), PU_LEVSPEC, 0);
+  flash = Z_BMalloc(&strobezone);
 
   memset(flash, 0, sizeof(*flash));
-  P_AddThinker (&flash->thinker);
+  P_AddPooledThinker (&flash->thinker, &strobezone);
 
   flash->sector = sector;
   flash->darktime = fastOrSlow;
@@ -277,10 +280,10 @@ void P_SpawnGlowingLight(sector_t*  sector)
 {
   glow_t* g;
 
-  g = Z_Malloc( sizeof(*g), PU_LEVSPEC, 0);
+  g = Z_BMalloc(&glowzone);
 
   memset(g, 0, sizeof(*g));
-  P_AddThinker(&g->thinker);
+  P_AddPooledThinker(&g->thinker, &glowzone);
 
   g->sector = sector;
   g->minlight = P_FindMinSurroundingLight(sector,sector->lightlevel);
@@ -751,10 +751,15 @@ boolean P_CheckPosition (mobj_t* thing,fixed_t x,fixed_t y)
   yh = (tmbbox[BOXTOP] - bmaporgy + MAXRADIUS)>>MAPBLOCKSHIFT;
 
 
+  sightcachelock++;
   for (bx=xl ; bx<=xh ; bx++)
     for (by=yl ; by<=yh ; by++)
       if (!P_BlockThingsIterator(bx,by,PIT_CheckThing))
+      {
+        sightcachelock--;
         return false;
+      }
+  sightcachelock--;
 
   // check lines
 
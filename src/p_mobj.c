@@ -803,6 +803,8 @@ void P_MobjThinker (mobj_t* mobj)
   }
 
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(mobjzone, sizeof(mobj_t), PU_LEVEL, 64, "Mobjs");
+
 //
 // P_SpawnMobj
 //
@@ -812,7 +814,7 @@ mobj_t* P_SpawnMobj(fixed_t x,fixed_t y,fixed_t z,mobjtype_t type)
   state_t*    st;
   mobjinfo_t* info;
 
-  mobj = Z_Malloc (sizeof(*mobj), PU_LEVEL, NULL);
+  mobj = Z_BMalloc(&mobjzone);
   memset (mobj, 0, sizeof (*mobj));
   info = &mobjinfo[type];
   mobj->type = type;
@@ -869,7 +871,7 @@ mobj_t* P_SpawnMobj(fixed_t x,fixed_t y,fixed_t z,mobjtype_t type)
   mobj->friction    = ORIG_FRICTION;                        // phares 3/17/98
 
   mobj->target = mobj->tracer = mobj->lastenemy = NULL;
-  P_AddThinker (&mobj->thinker);
+  P_AddPooledThinker (&mobj->thinker, &mobjzone);
   if (!((mobj->flags ^ MF_COUNTKILL) & (MF_FRIEND | MF_COUNTKILL)))
     totallive++;
   return mobj;
@@ -50,6 +50,8 @@
 // Needs precompiled tables/data structures.
 #include "info.h"
 
+#include "z_bmalloc.h"
+
 //
 // NOTES: mobj_t
 //
@@ -401,5 +403,8 @@ void    P_SpawnMapThing (const mapthing_t*  mthing);
 void    P_SpawnPlayer(int n, const mapthing_t *mthing);
 void    P_CheckMissileSpawn(mobj_t*);  // killough 8/2/98
 void    P_ExplodeMissile(mobj_t*);    // killough
+
+// Pool every mobj_t is allocated from
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(mobjzone);
 #endif
 
@@ -39,6 +39,8 @@
 #include "s_sound.h"
 #include "sounds.h"
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(platzone, sizeof(plat_t), PU_LEVSPEC, 16, "Plats");
+
 platlist_t *activeplats;       // killough 2/14/98: made global again
 
 //
@@ -218,9 +220,9 @@ int EV_DoPlat
 
     // Create a thinker
     rtn = 1;
-    plat = Z_Malloc( sizeof(*plat), PU_LEVSPEC, 0);
+    plat = Z_BMalloc(&platzone);
     memset(plat, 0, sizeof(*plat));
-    P_AddThinker(&plat->thinker);
+    P_AddPooledThinker(&plat->thinker, &platzone);
 
     plat->type = type;
     plat->sector = sec;
@@ -34,6 +34,7 @@
 #include "doomstat.h"
 #include "r_main.h"
 #include "p_maputl.h"
+#include "p_map.h"
 #include "p_spec.h"
 #include "p_tick.h"
 #include "p_saveg.h"
@@ -197,6 +198,9 @@ void P_UnArchiveWorld (void)
 
   get = (short *) save_p;
 
+  // the sector heights are about to change under any cached sight checks
+  P_InvalidateSightCache();
+
   // do sectors
   for (i=0, sec = sectors ; i<numsectors ; i++,sec++)
     {
@@ -436,13 +440,13 @@ void P_UnArchiveThinkers (void)
   save_p += sizeof brain;
 
   // remove all the current thinkers
-  for (th = thinkercap.next; th != &thinkercap; )
+  for (th = P_NextThinker(NULL, th_all); th; )
     {
-      thinker_t *next = th->next;
+      thinker_t *next = P_NextThinker(th, th_all);
       if (th->function == P_MobjThinker)
         P_RemoveMobj ((mobj_t *) th);
       else
-        Z_Free (th);
+        P_FreeThinker (th);
       th = next;
     }
   P_InitThinkers ();
@@ -468,7 +472,7 @@ void P_UnArchiveThinkers (void)
   // read in saved thinkers
   for (size = 1; *save_p++ == tc_mobj; size++)    // killough 2/14/98
     {
-      mobj_t *mobj = Z_Malloc(sizeof(mobj_t), PU_LEVEL, NULL);
+      mobj_t *mobj = Z_BMalloc(&mobjzone);
 
       // killough 2/14/98 -- insert pointers to thinkers into table, in order:
       mobj_p[size] = mobj;
@@ -510,7 +514,7 @@ void P_UnArchiveThinkers (void)
       //      mobj->ceilingz = mobj->subsector->sector->ceilingheight;
 
       mobj->thinker.function = P_MobjThinker;
-      P_AddThinker (&mobj->thinker);
+      P_AddPooledThinker (&mobj->thinker, &mobjzone);
 
       if (!((mobj->flags ^ MF_COUNTKILL) & (MF_FRIEND | MF_COUNTKILL | MF_CORPSE)))
         totallive++;
@@ -592,9 +596,11 @@ void P_ArchiveSpecials (void)
   thinker_t *th;
   size_t    size = 0;          // killough
 
+  P_SyncSleepingThinkers();    // sleeping lights save their real count
+
   // save off the current thinkers (memory size calculation -- killough)
 
-  for (th = thinkercap.next ; th != &thinkercap ; th=th->next)
+  for (th = P_NextThinker(NULL, th_all) ; th ; th = P_NextThinker(th, th_all))
     if (!th->function)
       {
         platlist_t *pl;
@@ -631,7 +637,7 @@ void P_ArchiveSpecials (void)
   CheckSaveGame(size + 1);    // killough; cph: +1 for the tc_endspecials
 
   // save off the current thinkers
-  for (th=thinkercap.next; th!=&thinkercap; th=th->next)
+  for (th = P_NextThinker(NULL, th_all); th; th = P_NextThinker(th, th_all))
     {
       if (!th->function)
         {
@@ -807,7 +813,7 @@ void P_UnArchiveSpecials (void)
       case tc_ceiling:
         PADSAVEP();
         {
-          ceiling_t *ceiling = Z_Malloc (sizeof(*ceiling), PU_LEVEL, NULL);
+          ceiling_t *ceiling = Z_BMalloc(&ceilingzone);
           memcpy (ceiling, save_p, sizeof(*ceiling));
           save_p += sizeof(*ceiling);
           ceiling->sector = &sectors[(int)ceiling->sector];
@@ -816,7 +822,7 @@ void P_UnArchiveSpecials (void)
           if (ceiling->thinker.function)
             ceiling->thinker.function = T_MoveCeiling;
 
-          P_AddThinker (&ceiling->thinker);
+          P_AddPooledThinker (&ceiling->thinker, &ceilingzone);
           P_AddActiveCeiling(ceiling);
           break;
         }
@@ -824,7 +830,7 @@ void P_UnArchiveSpecials (void)
       case tc_door:
         PADSAVEP();
         {
-          vldoor_t *door = Z_Malloc (sizeof(*door), PU_LEVEL, NULL);
+          vldoor_t *door = Z_BMalloc(&doorzone);
           memcpy (door, save_p, sizeof(*door));
           save_p += sizeof(*door);
           door->sector = &sectors[(int)door->sector];
@@ -834,27 +840,27 @@ void P_UnArchiveSpecials (void)
 
           door->sector->ceilingdata = door;       //jff 2/22/98
           door->thinker.function = T_VerticalDoor;
-          P_AddThinker (&door->thinker);
+          P_AddPooledThinker (&door->thinker, &doorzone);
           break;
         }
 
       case tc_floor:
         PADSAVEP();
         {
-          floormove_t *floor = Z_Malloc (sizeof(*floor), PU_LEVEL, NULL);
+          floormove_t *floor = Z_BMalloc(&floorzone);
           memcpy (floor, save_p, sizeof(*floor));
           save_p += sizeof(*floor);
           floor->sector = &sectors[(int)floor->sector];
           floor->sector->floordata = floor; //jff 2/22/98
           floor->thinker.function = T_MoveFloor;
-          P_AddThinker (&floor->thinker);
+          P_AddPooledThinker (&floor->thinker, &floorzone);
           break;
         }
 
       case tc_plat:
         PADSAVEP();
         {
-          plat_t *plat = Z_Malloc (sizeof(*plat), PU_LEVEL, NULL);
+          plat_t *plat = Z_BMalloc(&platzone);
           memcpy (plat, save_p, sizeof(*plat));
           save_p += sizeof(*plat);
           plat->sector = &sectors[(int)plat->sector];
@@ -863,7 +869,7 @@ void P_UnArchiveSpecials (void)
           if (plat->thinker.function)
             plat->thinker.function = T_PlatRaise;
 
-          P_AddThinker (&plat->thinker);
+          P_AddPooledThinker (&plat->thinker, &platzone);
           P_AddActivePlat(plat);
           break;
         }
@@ -883,24 +889,24 @@ void P_UnArchiveSpecials (void)
       case tc_strobe:
         PADSAVEP();
         {
-          strobe_t *strobe = Z_Malloc (sizeof(*strobe), PU_LEVEL, NULL);
+          strobe_t *strobe = Z_BMalloc (&strobezone);
           memcpy (strobe, save_p, sizeof(*strobe));
           save_p += sizeof(*strobe);
           strobe->sector = &sectors[(int)strobe->sector];
           strobe->thinker.function = T_StrobeFlash;
-          P_AddThinker (&strobe->thinker);
+          P_AddPooledThinker (&strobe->thinker, &strobezone);
           break;
         }
 
       case tc_glow:
         PADSAVEP();
         {
-          glow_t *glow = Z_Malloc (sizeof(*glow), PU_LEVEL, NULL);
+          glow_t *glow = Z_BMalloc (&glowzone);
           memcpy (glow, save_p, sizeof(*glow));
           save_p += sizeof(*glow);
           glow->sector = &sectors[(int)glow->sector];
           glow->thinker.function = T_Glow;
-          P_AddThinker (&glow->thinker);
+          P_AddPooledThinker (&glow->thinker, &glowzone);
           break;
         }
 
@@ -933,11 +939,11 @@ void P_UnArchiveSpecials (void)
 
       case tc_scroll:       // killough 3/7/98: scroll effect thinkers
         {
-          scroll_t *scroll = Z_Malloc (sizeof(scroll_t), PU_LEVEL, NULL);
+          scroll_t *scroll = Z_BMalloc (&scrollzone);
           memcpy (scroll, save_p, sizeof(scroll_t));
           save_p += sizeof(scroll_t);
           scroll->thinker.function = T_Scroll;
-          P_AddThinker(&scroll->thinker);
+          P_AddPooledThinker(&scroll->thinker, &scrollzone);
           break;
         }
 
@@ -48,10 +48,12 @@
 #include "p_tick.h"
 #include "p_enemy.h"
 #include "s_sound.h"
+#include "i_system.h"
 #include "lprintf.h" //jff 10/6/98 for debug outputs
 #include "v_video.h"
 #include "r_demo.h"
 #include "r_fps.h"
+#include "md5.h"
 #include "brew.h"
 
 //
@@ -141,6 +143,8 @@ long      *blockmaplump;          // was short -- killough
 
 fixed_t   bmaporgx, bmaporgy;     // origin of block map
 
+static long blockmapcount;        // entries in blockmaplump if created
+
 mobj_t    **blocklinks;           // for thing chains
 
 //
@@ -356,6 +360,34 @@ static int GetOffset(vertex_t *v1, vertex_t *v2)
 
 
 
+//
+// P_CalcSegDirections
+//
+// Unit vectors along the segs for the wall setup in R_StoreWallRange.
+// Called once the vertexes are final, after slime trail removal.
+//
+
+static void P_CalcSegDirections(void)
+{
+  int i;
+
+  for (i=0; i<numsegs; i++)
+    {
+      seg_t *li = segs+i;
+      double dx = (double)(li->v2->x - li->v1->x);
+      double dy = (double)(li->v2->y - li->v1->y);
+      double len = sqrt(dx*dx + dy*dy);
+
+      if (len > 0)
+        {
+          li->dirx = (fixed_t)(dx / len * FRACUNIT);
+          li->diry = (fixed_t)(dy / len * FRACUNIT);
+        }
+      else
+        li->dirx = li->diry = 0;
+    }
+}
+
 //
 // P_LoadSegs
 //
@@ -1138,7 +1170,8 @@ static void P_CreateBlockMap(void)
 
   // Create the blockmap lump
 
-  blockmaplump = Z_Malloc(sizeof(*blockmaplump) * (4+NBlocks+linetotal),
+  blockmapcount = 4+NBlocks+linetotal;
+  blockmaplump = Z_Malloc(sizeof(*blockmaplump) * blockmapcount,
                           PU_LEVEL, 0);
   // blockmap header
 
@@ -1187,12 +1220,19 @@ static void P_CreateBlockMap(void)
 // though current algorithm is brute-force and unoptimal.
 //
 
+static boolean P_MapCacheBlockMap(void);
+
 static void P_LoadBlockMap (int lump)
 {
   long count;
 
+  blockmapcount = 0;
+
   if (M_CheckParm("-blockmap") || W_LumpLength(lump)<8 || (count = W_LumpLength(lump)/2) >= 0x10000) //e6y
-    P_CreateBlockMap();
+  {
+    if (!P_MapCacheBlockMap())
+      P_CreateBlockMap();
+  }
   else
     {
       long i;
@@ -1412,6 +1452,51 @@ static int P_GroupLines (void)
   return total; // this value is needed by the reject overrun emulation code
 }
 
+//
+// P_BuildSectorGraph
+// Builds the sector sound lists from the line lists.
+//
+// Sound can only flood through lines flagged two-sided, which are fixed
+// once the level is loaded, so P_RecursiveSound walks just those with
+// the sector beyond already looked up instead of every line of a sector.
+//
+
+static void P_BuildSectorGraph(void)
+{
+  soundline_t *soundbuffer;
+  sector_t *sector;
+  line_t *li;
+  int i, j, total = 0;
+
+  for (i=0, sector = sectors; i<numsectors; i++, sector++)
+  {
+    sector->soundlinecount = 0;
+    for (j=0; j<sector->linecount; j++)
+      if (sector->lines[j]->flags & ML_TWOSIDED)
+        sector->soundlinecount++;
+    total += sector->soundlinecount;
+  }
+
+  soundbuffer = Z_Malloc(total*sizeof(soundline_t), PU_LEVEL, 0);
+
+  for (i=0, sector = sectors; i<numsectors; i++, sector++)
+  {
+    sector->soundlines = soundbuffer;
+    for (j=0; j<sector->linecount; j++)
+    {
+      li = sector->lines[j];
+      if (li->flags & ML_TWOSIDED)
+      {
+        // the same pick of side as P_RecursiveSound always made
+        soundbuffer->line = li;
+        soundbuffer->other =
+          sides[li->sidenum[sides[li->sidenum[0]].sector==sector]].sector-sectors;
+        soundbuffer++;
+      }
+    }
+  }
+}
+
 //
 // killough 10/98
 //
@@ -1494,6 +1579,234 @@ static void P_RemoveSlimeTrails(void)         // killough 10/98
   free(hit);
 }
 
+//
+// Level cache
+//
+// The blockmap built by P_CreateBlockMap and the vertexes moved by
+// P_RemoveSlimeTrails only depend on the map lumps, so they are kept in
+// <exedir>/<map>.pmc, keyed by the MD5 of those lumps, and read back in
+// one go on the next visit instead of being computed again. The sector
+// line lists and REJECT are not stored, P_GroupLines is linear and
+// REJECT already is a single lump read. -nomapcache disables this.
+//
+// Most maps have a blockmap lump and no slime trails to remove, so the
+// lumps are only hashed and the file only read once one of the two is
+// asked for.
+//
+
+#define MAPCACHE_MAGIC   0x434d4250 // "PBMC"
+#define MAPCACHE_VERSION 1
+
+typedef struct {
+  unsigned int magic;
+  unsigned int version;
+  unsigned char md5[16];
+  int blockmapcount;      // 0 if no blockmap stored
+  int bmaporgx, bmaporgy; // fixed_t
+  int bmapwidth, bmapheight;
+  int numvertexes;        // 0 if no vertexes stored
+} mapcache_t;
+
+static boolean mapcache_enabled;
+static boolean mapcache_read;   // file read, or found unusable
+static boolean mapcache_dirty;
+static int mapcache_lumpnum, mapcache_gl_lumpnum;
+static char mapcache_fname[PATH_MAX+1];
+static mapcache_t mapcache;
+static int *mapcache_blockmap;
+static int *mapcache_vertexes;
+
+static void P_MapCacheHashLumps(struct MD5Context *md5, int first, int count)
+{
+  int i;
+
+  for (i = first; i < first + count; i++)
+  {
+    MD5Update(md5, W_CacheLumpNum(i), W_LumpLength(i));
+    W_UnlockLumpNum(i);
+  }
+}
+
+static void P_MapCacheOpen(const char *mapname, int lumpnum, int gl_lumpnum)
+{
+  mapcache_read = mapcache_dirty = false;
+  mapcache_blockmap = mapcache_vertexes = NULL;
+  memset(&mapcache, 0, sizeof mapcache);
+
+  if (!(mapcache_enabled = !M_CheckParm("-nomapcache")))
+    return;
+
+  mapcache_lumpnum = lumpnum;
+  mapcache_gl_lumpnum = gl_lumpnum;
+  sprintf(mapcache_fname, "%s/%s.pmc", I_DoomExeDir(), mapname);
+}
+
+// Hashes the map lumps and reads the file if it was made from them,
+// the first time the blockmap or the vertexes are asked for
+static void P_MapCacheRead(void)
+{
+  struct MD5Context md5;
+  unsigned char key[16];
+  FILE *f;
+  boolean valid = false;
+
+  if (!mapcache_enabled || mapcache_read)
+    return;
+  mapcache_read = true;
+
+  MD5Init(&md5);
+  P_MapCacheHashLumps(&md5, mapcache_lumpnum + ML_THINGS, ML_BLOCKMAP);
+  if (nodesVersion > 0)
+    P_MapCacheHashLumps(&md5, mapcache_gl_lumpnum + ML_GL_VERTS, ML_GL_NODES);
+  MD5Final(key, &md5);
+
+  if ((f = fopen(mapcache_fname, "rb")) != NULL)
+  {
+    valid = fread(&mapcache, 1, sizeof mapcache, f) == sizeof mapcache &&
+      mapcache.magic == MAPCACHE_MAGIC &&
+      mapcache.version == MAPCACHE_VERSION &&
+      !memcmp(mapcache.md5, key, sizeof key) &&
+      mapcache.blockmapcount >= 0 && mapcache.numvertexes >= 0;
+
+    if (valid && mapcache.blockmapcount)
+    {
+      mapcache_blockmap = malloc(mapcache.blockmapcount * sizeof(int));
+      valid = fread(mapcache_blockmap, 1, mapcache.blockmapcount * sizeof(int), f)
+        == mapcache.blockmapcount * sizeof(int);
+    }
+    if (valid && mapcache.numvertexes)
+    {
+      mapcache_vertexes = malloc(mapcache.numvertexes * 2 * sizeof(int));
+      valid = fread(mapcache_vertexes, 1, mapcache.numvertexes * 2 * sizeof(int), f)
+        == mapcache.numvertexes * 2 * sizeof(int);
+    }
+    fclose(f);
+  }
+
+  if (!valid)
+  {
+    free(mapcache_blockmap);
+    free(mapcache_vertexes);
+    mapcache_blockmap = mapcache_vertexes = NULL;
+    memset(&mapcache, 0, sizeof mapcache);
+  }
+  memcpy(mapcache.md5, key, sizeof key);
+}
+
+// Returns true if the blockmap was taken from the cache, otherwise the
+// one P_CreateBlockMap is about to build will be stored
+static boolean P_MapCacheBlockMap(void)
+{
+  int i;
+
+  P_MapCacheRead();
+  if (!mapcache_blockmap)
+  {
+    mapcache_dirty = mapcache_enabled;
+    return false;
+  }
+
+  blockmapcount = mapcache.blockmapcount;
+  blockmaplump = Z_Malloc(sizeof(*blockmaplump) * blockmapcount, PU_LEVEL, 0);
+  for (i = 0; i < blockmapcount; i++)
+    blockmaplump[i] = mapcache_blockmap[i];
+
+  bmaporgx = mapcache.bmaporgx;
+  bmaporgy = mapcache.bmaporgy;
+  bmapwidth = mapcache.bmapwidth;
+  bmapheight = mapcache.bmapheight;
+  return true;
+}
+
+// Same for the vertexes moved by P_RemoveSlimeTrails
+static boolean P_MapCacheVertexes(void)
+{
+  int i;
+
+  P_MapCacheRead();
+  if (!mapcache_vertexes || mapcache.numvertexes != numvertexes)
+  {
+    mapcache_dirty = mapcache_enabled;
+    return false;
+  }
+
+  for (i = 0; i < numvertexes; i++)
+  {
+    vertexes[i].x = mapcache_vertexes[i*2+0];
+    vertexes[i].y = mapcache_vertexes[i*2+1];
+  }
+  return true;
+}
+
+static void P_MapCacheClose(boolean slimetrails)
+{
+  FILE *f;
+  int *t;
+  int i;
+
+  free(mapcache_blockmap);
+  free(mapcache_vertexes);
+  mapcache_blockmap = mapcache_vertexes = NULL;
+
+  if (!mapcache_dirty)
+    return;
+
+  if (!(f = fopen(mapcache_fname, "wb")))
+  {
+    lprintf(LO_WARN, "P_MapCacheClose: unable to write %s\n", mapcache_fname);
+    return;
+  }
+
+  mapcache.magic = MAPCACHE_MAGIC;
+  mapcache.version = MAPCACHE_VERSION;
+  mapcache.blockmapcount = blockmapcount;
+  mapcache.bmaporgx = bmaporgx;
+  mapcache.bmaporgy = bmaporgy;
+  mapcache.bmapwidth = bmapwidth;
+  mapcache.bmapheight = bmapheight;
+  mapcache.numvertexes = slimetrails ? numvertexes : 0;
+  fwrite(&mapcache, sizeof mapcache, 1, f);
+
+  // every fwrite is a file system call on BREW, write each array at once
+  t = malloc(MAX(mapcache.blockmapcount, mapcache.numvertexes * 2) * sizeof(int));
+  for (i = 0; i < mapcache.blockmapcount; i++)
+    t[i] = blockmaplump[i];
+  fwrite(t, sizeof(int), mapcache.blockmapcount, f);
+  for (i = 0; i < mapcache.numvertexes; i++)
+  {
+    t[i*2+0] = vertexes[i].x;
+    t[i*2+1] = vertexes[i].y;
+  }
+  fwrite(t, 2 * sizeof(int), mapcache.numvertexes, f);
+  free(t);
+
+  fclose(f);
+}
+
+//
+// P_LevelArenaSize
+// Estimates how much level data will be allocated while loading the map,
+// see Z_BeginLevelArena
+//
+static size_t P_LevelArenaSize(int lumpnum)
+{
+  size_t size =
+    W_LumpLength(lumpnum+ML_VERTEXES) / sizeof(mapvertex_t) * sizeof(vertex_t) +
+    W_LumpLength(lumpnum+ML_SEGS) / sizeof(mapseg_t) * sizeof(seg_t) +
+    W_LumpLength(lumpnum+ML_SSECTORS) / sizeof(mapsubsector_t) * sizeof(subsector_t) +
+    W_LumpLength(lumpnum+ML_NODES) / sizeof(mapnode_t) * sizeof(node_t) +
+    W_LumpLength(lumpnum+ML_SECTORS) / sizeof(mapsector_t) * sizeof(sector_t) +
+    W_LumpLength(lumpnum+ML_SIDEDEFS) / sizeof(mapsidedef_t) * sizeof(side_t) +
+    // lines and the sector line lists
+    W_LumpLength(lumpnum+ML_LINEDEFS) / sizeof(maplinedef_t) *
+      (sizeof(line_t) + 2*sizeof(line_t *)) +
+    // blockmap and its mobj chains
+    W_LumpLength(lumpnum+ML_BLOCKMAP) / 2 * (sizeof(*blockmaplump) + sizeof(*blocklinks));
+
+  // room for block headers, GL vertexes and the smaller tables
+  return size + size / 4;
+}
+
 //
 // P_SetupLevel
 //
@@ -1507,6 +1820,7 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   char  gl_lumpname[9];
   int   gl_lumpnum;
+  boolean slimetrails;
 
   R_StopAllInterpolations();
 
@@ -1522,7 +1836,11 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   // Make sure all sounds are stopped before Z_FreeTags.
   S_Start();
 
+  // keep what the last level converted before it can be purged
+  R_StorePatchCache();
+
   Z_FreeTags(PU_LEVEL, PU_PURGELEVEL-1);
+  Z_LogStats();
   if (rejectlump != -1) { // cph - unlock the reject table
     W_UnlockLumpNum(rejectlump);
     rejectlump = -1;
@@ -1569,6 +1887,8 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 #if 1
   // figgi 10/19/00 -- check for gl lumps and load them
   P_GetNodesVersion(lumpnum,gl_lumpnum);
+  P_MapCacheOpen(lumpname, lumpnum, gl_lumpnum);
+  Z_BeginLevelArena(P_LevelArenaSize(lumpnum));
 
   if (nodesVersion > 0)
     P_LoadVertexes2 (lumpnum+ML_VERTEXES,gl_lumpnum+ML_GL_VERTS);
@@ -1612,13 +1932,22 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   // reject loading and underflow padding separated out into new function
   // P_GroupLines modified to return a number the underflow padding needs
   P_LoadReject(lumpnum, P_GroupLines());
+  P_BuildSectorGraph();
 
   // e6y
   // Correction of desync on dv04-423.lmp/dv.wad
   // http://www.doomworld.com/vb/showthread.php?s=&postid=627257#post627257
-  if (compatibility_level>=lxdoom_1_compatibility || M_CheckParm("-force_remove_slime_trails") > 0)
+  slimetrails = compatibility_level>=lxdoom_1_compatibility || M_CheckParm("-force_remove_slime_trails") > 0;
+  if (slimetrails && !P_MapCacheVertexes())
     P_RemoveSlimeTrails();    // killough 10/98: remove slime trails from wad
 
+  P_MapCacheClose(slimetrails);
+  P_CalcSegDirections();
+  P_InvalidateSightCache();
+
+  // map data is in, the thinkers spawned from here on come and go
+  Z_EndLevelArena();
+
   // Note: you don't need to clear player queue slots --
   // a much simpler fix is in g_game.c -- killough 10/98
 
@@ -1663,9 +1992,9 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   P_MapEnd();
 
-  // preload graphics
-  if (precache)
-    R_PrecacheLevel();
+  // preload graphics, or queue them to be loaded between frames
+  R_PrecacheLevel();
+  R_StorePatchCache();
 
 #ifdef GL_DOOM
   if (V_GetMode() == VID_MODEGL)
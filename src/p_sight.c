@@ -55,6 +55,52 @@ typedef struct {
 
 static los_t los; // cph - made static
 
+// Results of full traversals, keyed by everything P_CheckSight reads
+// from the two mobjs. The rest of the answer comes from sector heights,
+// so any plane movement invalidates the whole cache by bumping
+// sightepoch; idle monsters looking at a player who stands still then
+// get their answer without walking the BSP every tic.
+
+#define SIGHTCACHESIZE 256 // power of 2
+
+typedef struct {
+  fixed_t x1, y1, z1, h1;
+  fixed_t x2, y2, z2, h2;
+  unsigned int epoch;
+  boolean visible;
+} sightcache_t;
+
+static sightcache_t sightcache[SIGHTCACHESIZE];
+static unsigned int sightepoch = 1;
+
+// P_CheckPosition runs thing callbacks and then scans lines with the
+// same validcount, so a sight check made from inside (a pain or death
+// action of something hit) has to stamp the lines it crosses as before
+int sightcachelock;
+
+static struct {
+  unsigned int checks, reject, fakefloor, samesubsector, cached, traversed;
+} sightstats;
+
+void P_InvalidateSightCache(void)
+{
+  if (!++sightepoch)
+  {
+    memset(sightcache, 0, sizeof sightcache);
+    sightepoch = 1;
+  }
+}
+
+void P_LogSightStats(void)
+{
+  if (sightstats.checks)
+    lprintf(LO_INFO, "P_LogSightStats: %u checks, %u reject, %u fake floor, "
+            "%u same subsector, %u cached, %u traversed\n",
+            sightstats.checks, sightstats.reject, sightstats.fakefloor,
+            sightstats.samesubsector, sightstats.cached, sightstats.traversed);
+  memset(&sightstats, 0, sizeof sightstats);
+}
+
 //
 // P_DivlineSide
 // Returns side 0 (front), 1 (back), or 2 (on).
@@ -264,6 +310,10 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
   const sector_t *s1 = t1->subsector->sector;
   const sector_t *s2 = t2->subsector->sector;
   int pnum = (s1-sectors)*numsectors + (s2-sectors);
+  sightcache_t *entry;
+  unsigned int hash;
+
+  sightstats.checks++;
 
   // First check for trivial rejection.
   // Determine subsector entries in REJECT table.
@@ -271,7 +321,10 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
   // Check in REJECT table.
 
   if (rejectmatrix[pnum>>3] & (1 << (pnum&7)))   // can't possibly be connected
+  {
+    sightstats.reject++;
     return false;
+  }
 
   // killough 4/19/98: make fake floors and ceilings block monster view
 
@@ -286,20 +339,41 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
          t1->z >= sectors[s2->heightsec].floorheight) ||
         (t2->z >= sectors[s2->heightsec].ceilingheight &&
          t1->z + t2->height <= sectors[s2->heightsec].ceilingheight))))
+  {
+    sightstats.fakefloor++;
     return false;
+  }
 
   /* killough 11/98: shortcut for melee situations
    * same subsector? obviously visible
    * cph - compatibility optioned for demo sync, cf HR06-UV.LMP */
   if ((t1->subsector == t2->subsector) &&
       (compatibility_level >= mbf_compatibility))
+  {
+    sightstats.samesubsector++;
     return true;
+  }
 
   // An unobstructed LOS is possible.
   // Now look from eyes of t1 to any part of t2.
 
   validcount++;
 
+  hash = (t1->x ^ t2->y) + (t1->y ^ t2->x) * 31 + (t1->z ^ t2->z);
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  entry = &sightcache[hash & (SIGHTCACHESIZE-1)];
+
+  if (!sightcachelock && entry->epoch == sightepoch &&
+      entry->x1 == t1->x && entry->y1 == t1->y &&
+      entry->z1 == t1->z && entry->h1 == t1->height &&
+      entry->x2 == t2->x && entry->y2 == t2->y &&
+      entry->z2 == t2->z && entry->h2 == t2->height)
+  {
+    sightstats.cached++;
+    return entry->visible;
+  }
+
   los.topslope = (los.bottomslope = t2->z - (los.sightzstart =
                                              t1->z + t1->height -
                                              (t1->height>>2))) + t2->height;
@@ -334,5 +408,9 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
   }
 
   // the head node is the last node output
-  return P_CrossBSPNode(numnodes-1);
+  sightstats.traversed++;
+  entry->x1 = t1->x; entry->y1 = t1->y; entry->z1 = t1->z; entry->h1 = t1->height;
+  entry->x2 = t2->x; entry->y2 = t2->y; entry->z2 = t2->z; entry->h2 = t2->height;
+  entry->epoch = sightepoch;
+  return entry->visible = P_CrossBSPNode(numnodes-1);
 }
@@ -2708,10 +2708,12 @@ void T_Scroll(scroll_t *s)
 // accel: non-zero if this is an accelerative effect
 //
 
+IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(scrollzone, sizeof(scroll_t), PU_LEVSPEC, 32, "Scrollers");
+
 static void Add_Scroller(int type, fixed_t dx, fixed_t dy,
                          int control, int affectee, int accel)
 {
-  scroll_t *s = Z_Malloc(sizeof *s, PU_LEVSPEC, 0);
+  scroll_t *s = Z_BMalloc(&scrollzone);
   s->thinker.function = T_Scroll;
   s->type = type;
   s->dx = dx;
@@ -2722,7 +2724,7 @@ static void Add_Scroller(int type, fixed_t dx, fixed_t dy,
     s->last_height =
       sectors[control].floorheight + sectors[control].ceilingheight;
   s->affectee = affectee;
-  P_AddThinker(&s->thinker);
+  P_AddPooledThinker(&s->thinker, &scrollzone);
 }
 
 // Adds wall scroller. Scroll amount is rotated with respect to wall's
@@ -35,6 +35,7 @@
 
 #include "r_defs.h"
 #include "d_player.h"
+#include "z_bmalloc.h"
 
 //      Define values for map objects
 #define MO_TELEPORTMAN  14
@@ -1138,4 +1139,15 @@ int P_ActivateInStasisCeiling
 
 mobj_t* P_GetPushThing(int);                                // phares 3/23/98
 
+// Pools the moving sector specials are allocated from
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(ceilingzone);
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(doorzone);
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(floorzone);
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(platzone);
+
+// Pools of the thinkers P_RunThinkers runs in batches
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(glowzone);
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(strobezone);
+DECLARE_BLOCK_MEMORY_ALLOC_ZONE(scrollzone);
+
 #endif
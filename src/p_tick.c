@@ -54,6 +54,51 @@ static boolean newthinkerpresent;
 // a special class of thinkers, to allow more efficient searches.
 thinker_t thinkerclasscap[th_all+1];
 
+// Thinkers that only change how sectors and walls look, and draw nothing
+// from the random number generator, can't affect demo sync whatever
+// order they run in. They are taken off the main list the first time
+// they run and kept on one list per function instead, allocated from
+// their own pools, so each kind runs as a batch over nearby memory.
+// Thinkers that move things (friction, pushers, carrying scrollers)
+// keep their place in the main list, as demos depend on it.
+//
+// Strobes, flashes and flickers do nothing but count down most tics.
+// They sleep on the tb_sleep list instead, and a heap ordered by the tic
+// their count runs out, then by the order they went to sleep, wakes
+// them on that tic only. Flashes and flickers call P_Random when they
+// wake. Waking them after the main list keeps demos in sync only when
+// lights draw from their own random number stream, or when there is no
+// demo or netgame to stay in sync with. Otherwise they stay in the main
+// list.
+typedef enum {
+  tb_glow,
+  tb_scroll,
+  tb_sleep,     // not run as a batch, woken from sleepheap
+  NUMTHBATCH
+} th_batch;
+
+static thinker_t thinkerbatchcap[NUMTHBATCH];
+
+typedef struct {
+  int tic;            // leveltime of the tic the count runs out on
+  unsigned int seq;   // order the thinker went to sleep in
+  thinker_t *thinker;
+} sleeper_t;
+
+static sleeper_t *sleepheap;
+static int numsleepers, maxsleepers;
+static unsigned int sleepseq;
+
+static int P_ThinkerBatch(const thinker_t *thinker)
+{
+  if (thinker->function == T_Glow)
+    return tb_glow;
+  if (thinker->function == T_Scroll &&
+      ((const scroll_t *) thinker)->type < sc_carry) // textures only
+    return tb_scroll;
+  return -1;
+}
+
 //
 // P_InitThinkers
 //
@@ -66,6 +111,12 @@ void P_InitThinkers(void)
     thinkerclasscap[i].cprev = thinkerclasscap[i].cnext = &thinkerclasscap[i];
 
   thinkercap.prev = thinkercap.next  = &thinkercap;
+
+  for (i=0; i<NUMTHBATCH; i++)
+    thinkerbatchcap[i].prev = thinkerbatchcap[i].next = &thinkerbatchcap[i];
+
+  numsleepers = 0;
+  sleepseq = 0;
 }
 
 //
@@ -116,6 +167,7 @@ void P_AddThinker(thinker_t* thinker)
   thinkercap.prev = thinker;
 
   thinker->references = 0;    // killough 11/98: init reference counter to 0
+  thinker->zone = NULL;
 
   // killough 8/29/98: set sentinel pointers, and then add to appropriate list
   thinker->cnext = thinker->cprev = NULL;
@@ -123,6 +175,18 @@ void P_AddThinker(thinker_t* thinker)
   newthinkerpresent = true;
 }
 
+//
+// P_AddPooledThinker
+// Adds a thinker allocated from a block memory zone, which
+// P_FreeThinker returns it to.
+//
+
+void P_AddPooledThinker(thinker_t *thinker, struct block_memory_alloc_s *zone)
+{
+  P_AddThinker(thinker);
+  thinker->zone = zone;
+}
+
 //
 // killough 11/98:
 //
@@ -159,10 +223,26 @@ void P_RemoveThinkerDelayed(thinker_t *thinker)
         thinker_t *th = thinker->cnext;
         (th->cprev = thinker->cprev)->cnext = th;
       }
-      Z_Free(thinker);
+      P_FreeThinker(thinker);
     }
 }
 
+//
+// P_FreeThinker
+//
+// Returns a thinker's memory to the pool it came from. The thinker's
+// type can't be told from its function any more by the time it's freed,
+// so P_AddPooledThinker noted the pool.
+//
+
+void P_FreeThinker(thinker_t *thinker)
+{
+  if (thinker->zone)
+    Z_BFree(thinker->zone, thinker);
+  else
+    Z_Free(thinker);
+}
+
 //
 // P_RemoveThinker
 //
@@ -191,8 +271,27 @@ thinker_t* P_NextThinker(thinker_t* th, th_class cl)
 {
   thinker_t* top = &thinkerclasscap[cl];
   if (!th) th = top;
-  th = cl == th_all ? th->next : th->cnext;
-  return th == top ? NULL : th;
+  if (cl != th_all)
+  {
+    th = th->cnext;
+    return th == top ? NULL : th;
+  }
+
+  // the main list goes on into the batched ones
+  th = th->next;
+  for (;;)
+  {
+    if (th == top)
+      th = thinkerbatchcap[0].next;
+    else if (th >= thinkerbatchcap && th < thinkerbatchcap + NUMTHBATCH)
+    {
+      if (th == &thinkerbatchcap[NUMTHBATCH-1])
+        return NULL;
+      th = (th+1)->next;
+    }
+    else
+      return th;
+  }
 }
 
 /*
@@ -215,6 +314,157 @@ void P_SetTarget(mobj_t **mop, mobj_t *targ)
     targ->thinker.references++;
 }
 
+static boolean P_LightsMaySleep(void)
+{
+  return (!demo_compatibility && demo_insurance) ||
+    (!demorecording && !demoplayback && !netgame);
+}
+
+static int *P_LightTimer(thinker_t *thinker)
+{
+  if (thinker->function == T_StrobeFlash)
+    return &((strobe_t *) thinker)->count;
+  if (thinker->function == T_LightFlash)
+    return &((lightflash_t *) thinker)->count;
+  if (thinker->function == T_FireFlicker)
+    return &((fireflicker_t *) thinker)->count;
+  return NULL;
+}
+
+// Returns the countdown of a thinker that may sleep, or NULL
+static int *P_SleepTimer(thinker_t *thinker)
+{
+  if (thinker->function != T_StrobeFlash && !P_LightsMaySleep())
+    return NULL;
+  return P_LightTimer(thinker);
+}
+
+#define SLEEPER_BEFORE(a, b) \
+  ((a).tic < (b).tic || ((a).tic == (b).tic && (a).seq < (b).seq))
+
+static void P_SiftSleeperDown(int i)
+{
+  sleeper_t s = sleepheap[i];
+  int child;
+
+  while ((child = i*2+1) < numsleepers)
+  {
+    if (child+1 < numsleepers && SLEEPER_BEFORE(sleepheap[child+1], sleepheap[child]))
+      child++;
+    if (!SLEEPER_BEFORE(sleepheap[child], s))
+      break;
+    sleepheap[i] = sleepheap[child];
+    i = child;
+  }
+  sleepheap[i] = s;
+}
+
+//
+// P_SleepThinker
+// Moves currentthinker, which has just run, from the main list to the
+// sleeping ones until its count runs out
+//
+
+static void P_SleepThinker(int count)
+{
+  thinker_t *th = currentthinker, *cap = &thinkerbatchcap[tb_sleep];
+  sleeper_t s;
+  int i;
+
+  (th->next->prev = currentthinker = th->prev)->next = th->next;
+  cap->prev->next = th;
+  th->next = cap;
+  th->prev = cap->prev;
+  cap->prev = th;
+
+  if (numsleepers == maxsleepers)
+  {
+    maxsleepers = maxsleepers ? maxsleepers*2 : 256;
+    sleepheap = realloc(sleepheap, maxsleepers * sizeof *sleepheap);
+  }
+
+  s.tic = leveltime + (count > 0 ? count : 1);
+  s.seq = sleepseq++;
+  s.thinker = th;
+  for (i = numsleepers++; i && SLEEPER_BEFORE(s, sleepheap[(i-1)/2]); i = (i-1)/2)
+    sleepheap[i] = sleepheap[(i-1)/2];
+  sleepheap[i] = s;
+}
+
+//
+// P_WakeThinkers
+// Runs the sleeping thinkers whose count runs out this tic, in the
+// order they went to sleep
+//
+
+static void P_WakeThinkers(void)
+{
+  while (numsleepers && sleepheap[0].tic <= leveltime)
+  {
+    thinker_t *th = currentthinker = sleepheap[0].thinker;
+    int *timer = P_SleepTimer(th);
+
+    if (timer)
+    {
+      *timer = 1;   // runs out on this call
+      th->function(th);
+    }
+    if (currentthinker == th && (timer = P_SleepTimer(th)) != NULL)
+    {
+      sleepheap[0].tic = leveltime + (*timer > 0 ? *timer : 1);
+      P_SiftSleeperDown(0);
+    }
+    else
+    {
+      // removed
+      sleepheap[0] = sleepheap[--numsleepers];
+      if (numsleepers)
+        P_SiftSleeperDown(0);
+    }
+  }
+}
+
+//
+// P_SyncSleepingThinkers
+// Writes the remaining count back into each sleeping thinker, so they
+// are saved as if they had counted down every tic
+//
+
+void P_SyncSleepingThinkers(void)
+{
+  int i;
+
+  for (i = 0; i < numsleepers; i++)
+  {
+    int *timer = P_LightTimer(sleepheap[i].thinker);
+    if (timer)
+      *timer = sleepheap[i].tic - leveltime + 1;
+  }
+}
+
+//
+// P_WakeAllThinkers
+// Puts the sleeping thinkers back at the end of the main list, for when
+// they may no longer sleep
+//
+
+static void P_WakeAllThinkers(void)
+{
+  thinker_t *cap = &thinkerbatchcap[tb_sleep];
+
+  P_SyncSleepingThinkers();
+  numsleepers = 0;
+
+  if (cap->next != cap)
+  {
+    cap->next->prev = thinkercap.prev;
+    thinkercap.prev->next = cap->next;
+    cap->prev->next = &thinkercap;
+    thinkercap.prev = cap->prev;
+    cap->prev = cap->next = cap;
+  }
+}
+
 //
 // P_RunThinkers
 //
@@ -240,15 +490,50 @@ void P_SetTarget(mobj_t **mop, mobj_t *targ)
 
 static void P_RunThinkers (void)
 {
+  int b, *timer;
+
+  if (numsleepers && !P_LightsMaySleep())
+    P_WakeAllThinkers();
+
   for (currentthinker = thinkercap.next;
        currentthinker != &thinkercap;
        currentthinker = currentthinker->next)
   {
     if (newthinkerpresent)
+    {
       R_ActivateThinkerInterpolations(currentthinker);
+
+      // only new thinkers can be batchable ones still on the main
+      // list; move them to their batch, which runs them this tic too
+      if ((b = P_ThinkerBatch(currentthinker)) >= 0)
+      {
+        thinker_t *th = currentthinker, *cap = &thinkerbatchcap[b];
+
+        (th->next->prev = currentthinker = th->prev)->next = th->next;
+        cap->prev->next = th;
+        th->next = cap;
+        th->prev = cap->prev;
+        cap->prev = th;
+        continue;
+      }
+    }
     if (currentthinker->function)
       currentthinker->function(currentthinker);
+
+    // new lights run their first tic in place, then go to sleep
+    if (newthinkerpresent && (timer = P_SleepTimer(currentthinker)) != NULL)
+      P_SleepThinker(*timer);
   }
+
+  P_WakeThinkers();
+
+  for (b = 0; b < tb_sleep; b++)
+    for (currentthinker = thinkerbatchcap[b].next;
+         currentthinker != &thinkerbatchcap[b];
+         currentthinker = currentthinker->next)
+      if (currentthinker->function)
+        currentthinker->function(currentthinker);
+
   newthinkerpresent = false;
 }
 
@@ -46,8 +46,11 @@ void P_Ticker(void);
 
 void P_InitThinkers(void);
 void P_AddThinker(thinker_t *thinker);
+void P_AddPooledThinker(thinker_t *thinker, struct block_memory_alloc_s *zone);
 void P_RemoveThinker(thinker_t *thinker);
 void P_RemoveThinkerDelayed(thinker_t *thinker);    // killough 4/25/98
+void P_FreeThinker(thinker_t *thinker);
+void P_SyncSleepingThinkers(void);
 
 void P_UpdateThinker(thinker_t *thinker);   // killough 8/29/98
 
@@ -149,6 +149,7 @@ static boolean PrBoomApp_InitAppData(PrBoomApp *pApp)
     return FALSE;
   }
 
+#ifndef NULL_VIDEO // VIDEO=null builds have no display, see null_blit.c
   if (!InitGL())
   {
     printf("Failed to InitGL");
@@ -160,6 +161,7 @@ static boolean PrBoomApp_InitAppData(PrBoomApp *pApp)
     printf("Failed to SetupGL");
     return (FALSE);
   }
+#endif
 
 #ifndef AEE_SIMULATOR
   if (ISHELL_CreateInstance(pApp->a.m_pIShell, AEECLSID_HID,
@@ -275,6 +277,14 @@ static boolean PrBoomApp_InitAppData(PrBoomApp *pApp)
   return TRUE;
 }
 
+#ifdef NULL_VIDEO
+
+void FreeGLSurface()
+{
+}
+
+#else
+
 void FreeGLSurface()
 {
   if (pApp->eglDisplay != EGL_NO_DISPLAY)
@@ -441,6 +451,8 @@ boolean SetupGL(void)
   return TRUE;
 }
 
+#endif
+
 static boolean PrBoomApp_HandleEvent(PrBoomApp *pApp, AEEEvent eCode,
                                      uint16 wParam, uint32 dwParam)
 {
@@ -649,10 +649,23 @@ int PUREFUNC R_SafeTextureNumForName(const char *name, int snum)
 // Totally rewritten by Lee Killough to use less memory,
 // to avoid using alloca(), and to improve performance.
 // cph - new wad lump handling, calls cache functions but acquires no locks
+//
+// The lumps are collected first and handed to W_PrefetchLumps in one
+// go, so the cache can fit as many of them as its budget allows. Without
+// level_precache they are queued to be read between frames instead.
+
+static int *prefetchlist, prefetchcount;
 
-static inline void precache_lump(int l)
+static void precache_lump(int l)
 {
-  W_CacheLumpNum(l); W_UnlockLumpNum(l);
+  static int prefetchsize;
+
+  if (prefetchcount >= prefetchsize)
+  {
+    prefetchsize = prefetchsize ? prefetchsize*2 : 256;
+    prefetchlist = realloc(prefetchlist, prefetchsize * sizeof *prefetchlist);
+  }
+  prefetchlist[prefetchcount++] = l;
 }
 
 void R_PrecacheLevel(void)
@@ -663,6 +676,8 @@ void R_PrecacheLevel(void)
   if (demoplayback)
     return;
 
+  prefetchcount = 0;
+
   {
     size_t size = numflats > numsprites  ? numflats : numsprites;
     hitlist = malloc((size_t)numtextures > size ? numtextures : size);
@@ -730,6 +745,11 @@ void R_PrecacheLevel(void)
           }
       }
   free(hitlist);
+
+  if (precache)
+    W_PrefetchLumps(prefetchlist, prefetchcount);
+  else
+    W_QueueLumps(prefetchlist, prefetchcount);
 }
 
 // Proff - Added for OpenGL
@@ -83,6 +83,13 @@ typedef struct
   fixed_t x, y, z;
 } degenmobj_t;
 
+// A line sound can pass through, and the sector on its other side
+typedef struct
+{
+  struct line_s *line;
+  int other;             // sector number
+} soundline_t;
+
 //
 // The SECTORS record, at runtime.
 // Stores things/mobjs.
@@ -131,6 +138,10 @@ typedef struct
   int linecount;
   struct line_s **lines;
 
+  // the two-sided subset of lines, in the same order, for P_RecursiveSound
+  int soundlinecount;
+  soundline_t *soundlines;
+
   // killough 10/98: support skies coming from sidedefs. Allows scrolling
   // skies and other effects. No "level info" kind of lump is needed,
   // because you can use an arbitrary number of skies per level with this
@@ -259,6 +270,9 @@ typedef struct
   float     length;
   boolean   miniseg;
 
+  // unit vector from v1 to v2, for the division-free wall setup
+  fixed_t dirx, diry;
+
 
   // Sector references.
   // Could be retrieved from linedef, too
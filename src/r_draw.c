@@ -291,6 +291,52 @@ void R_ResetColumnBuffer(void)
 #define R_FLUSHQUAD_FUNCNAME R_FlushQuadFuzz32
 #include "r_drawflush.inl"
 
+//
+// R_Colormap16
+//
+// The 16 bit drawers look texels up here instead of going through
+// colormap and then V_Palette16 for every pixel. The light levels of
+// fullcolormap are converted together, as all colormaps of a frame but
+// the inverse one come from there. Anything else gets a single cached
+// 256 entry table.
+//
+
+static unsigned short fullcolormap16[NUMCOLORMAPS*256];
+static const lighttable_t *fullcolormap16_src;
+static unsigned int fullcolormap16_gen;
+
+static unsigned short othercolormap16[256];
+static const lighttable_t *othercolormap16_src;
+static unsigned int othercolormap16_gen;
+
+static void R_ConvertColormap16(unsigned short *dest, const lighttable_t *src, int count)
+{
+  while (count--)
+    *dest++ = VID_PAL16(*src++, VID_COLORWEIGHTMASK);
+}
+
+const unsigned short *R_Colormap16(const lighttable_t *colormap)
+{
+  if (colormap >= fullcolormap && colormap < fullcolormap + NUMCOLORMAPS*256)
+  {
+    if (fullcolormap16_src != fullcolormap || fullcolormap16_gen != V_PaletteGeneration)
+    {
+      R_ConvertColormap16(fullcolormap16, fullcolormap, NUMCOLORMAPS*256);
+      fullcolormap16_src = fullcolormap;
+      fullcolormap16_gen = V_PaletteGeneration;
+    }
+    return fullcolormap16 + (colormap - fullcolormap);
+  }
+
+  if (othercolormap16_src != colormap || othercolormap16_gen != V_PaletteGeneration)
+  {
+    R_ConvertColormap16(othercolormap16, colormap, 256);
+    othercolormap16_src = colormap;
+    othercolormap16_gen = V_PaletteGeneration;
+  }
+  return othercolormap16;
+}
+
 //
 // R_DrawColumn
 //
@@ -1069,10 +1115,12 @@ void R_FillBackScreen (void)
 
 void R_VideoErase(int x, int y, int count)
 {
-  if (V_GetMode() != VID_MODEGL)
+  if (V_GetMode() != VID_MODEGL) {
     memcpy(screens[0].data+y*screens[0].byte_pitch+x*V_GetPixelDepth(),
            screens[1].data+y*screens[1].byte_pitch+x*V_GetPixelDepth(),
            count*V_GetPixelDepth());   // LFB copy.
+    V_DirtyRows[y] = 1;
+  }
 }
 
 //
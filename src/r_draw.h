@@ -91,6 +91,9 @@ void R_SetDefaultDrawColumnVars(draw_column_vars_t *dcvars);
 
 void R_VideoErase(int x, int y, int count);
 
+// Colormap converted to 16 bit pixels with the current palette
+const unsigned short *R_Colormap16(const lighttable_t *colormap);
+
 typedef struct {
   int                 y;
   int                 x1;
@@ -64,6 +64,15 @@
   #endif
 #endif
 
+// 16 bit drawers with a single colormap read pixels straight from its
+// converted table, see R_Colormap16
+#if (R_DRAWCOLUMN_PIPELINE_BITS == 16) && !(R_DRAWCOLUMN_PIPELINE & (RDC_NOCOLMAP|RDC_DITHERZ|RDC_BILINEAR|RDC_FUZZ))
+  #define USE_COLORMAP16
+  #define GETCOL16_DEPTH(col) colormap16[GETCOL8_MAPPED(col)]
+#else
+  #define GETCOL16_DEPTH(col) VID_PAL16(GETCOL8_DEPTH(col), VID_COLORWEIGHTMASK)
+#endif
+
 #if (R_DRAWCOLUMN_PIPELINE & RDC_BILINEAR)
  #define GETCOL8(frac, nextfrac) GETCOL8_DEPTH(filter_getDitheredForColumn(x,y,frac,nextfrac))
  #define GETCOL15(frac, nextfrac) filter_getFilteredForColumn15(GETCOL8_DEPTH,frac,nextfrac)
@@ -72,12 +81,12 @@
 #elif (R_DRAWCOLUMN_PIPELINE & RDC_ROUNDED)
  #define GETCOL8(frac, nextfrac) GETCOL8_DEPTH(filter_getRoundedForColumn(frac,nextfrac))
  #define GETCOL15(frac, nextfrac) VID_PAL15(GETCOL8_DEPTH(filter_getRoundedForColumn(frac,nextfrac)), VID_COLORWEIGHTMASK)
- #define GETCOL16(frac, nextfrac) VID_PAL16(GETCOL8_DEPTH(filter_getRoundedForColumn(frac,nextfrac)), VID_COLORWEIGHTMASK)
+ #define GETCOL16(frac, nextfrac) GETCOL16_DEPTH(filter_getRoundedForColumn(frac,nextfrac))
  #define GETCOL32(frac, nextfrac) VID_PAL32(GETCOL8_DEPTH(filter_getRoundedForColumn(frac,nextfrac)), VID_COLORWEIGHTMASK)
 #else
  #define GETCOL8(frac, nextfrac) GETCOL8_DEPTH(source[(frac)>>FRACBITS])
  #define GETCOL15(frac, nextfrac) VID_PAL15(GETCOL8_DEPTH(source[(frac)>>FRACBITS]), VID_COLORWEIGHTMASK)
- #define GETCOL16(frac, nextfrac) VID_PAL16(GETCOL8_DEPTH(source[(frac)>>FRACBITS]), VID_COLORWEIGHTMASK)
+ #define GETCOL16(frac, nextfrac) GETCOL16_DEPTH(source[(frac)>>FRACBITS])
  #define GETCOL32(frac, nextfrac) VID_PAL32(GETCOL8_DEPTH(source[(frac)>>FRACBITS]), VID_COLORWEIGHTMASK)
 #endif
 
@@ -251,6 +260,9 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
     const byte          *source = dcvars->source;
     const lighttable_t  *colormap = dcvars->colormap;
     const byte          *translation = dcvars->translation;
+#ifdef USE_COLORMAP16
+    const unsigned short *colormap16 = R_Colormap16(colormap);
+#endif
 #if (R_DRAWCOLUMN_PIPELINE & (RDC_BILINEAR|RDC_ROUNDED|RDC_DITHERZ))
     int y = dcvars->yl;
     const int x = dcvars->x;
@@ -363,6 +375,8 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
 #undef GETDESTCOLOR
 #undef GETCOL8_MAPPED
 #undef GETCOL8_DEPTH
+#undef GETCOL16_DEPTH
+#undef USE_COLORMAP16
 #undef GETCOL32
 #undef GETCOL16
 #undef GETCOL15
@@ -55,6 +55,10 @@
 #define GETDESTCOLOR15(col1, col2) (GETBLENDED15_3268((col1), (col2)))
 #define GETDESTCOLOR16(col1, col2) (GETBLENDED16_3268((col1), (col2)))
 #define GETDESTCOLOR32(col1, col2) (GETBLENDED32_3268((col1), (col2)))
+#define GETSPLITCOLOR15(col1, col2) \
+  (GETBLENDED15_3268_SPLIT(SPLIT15(col1), SPLIT15(col2)))
+#define GETSPLITCOLOR16(col1, col2) \
+  (GETBLENDED16_3268_SPLIT(SPLIT16(col1), SPLIT16(col2)))
 #elif (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
 #define GETDESTCOLOR8(col) (tempfuzzmap[6*256+(col)])
 #define GETDESTCOLOR15(col) GETBLENDED15_9406(col, 0)
@@ -225,6 +229,26 @@ static void R_FLUSHQUAD_FUNCNAME(void)
    count = commonbot - commontop + 1;
 
 #if (R_DRAWCOLUMN_PIPELINE & RDC_TRANSLUCENT)
+  #if (R_DRAWCOLUMN_PIPELINE_BITS == 15) || (R_DRAWCOLUMN_PIPELINE_BITS == 16)
+   // blend with the pixels split into one word each, which saves half
+   // the multiplies of GETDESTCOLOR and gives the same colours
+   while(--count >= 0)
+   {
+    #if (R_DRAWCOLUMN_PIPELINE_BITS == 15)
+      dest[0] = GETSPLITCOLOR15(dest[0], source[0]);
+      dest[1] = GETSPLITCOLOR15(dest[1], source[1]);
+      dest[2] = GETSPLITCOLOR15(dest[2], source[2]);
+      dest[3] = GETSPLITCOLOR15(dest[3], source[3]);
+    #else
+      dest[0] = GETSPLITCOLOR16(dest[0], source[0]);
+      dest[1] = GETSPLITCOLOR16(dest[1], source[1]);
+      dest[2] = GETSPLITCOLOR16(dest[2], source[2]);
+      dest[3] = GETSPLITCOLOR16(dest[3], source[3]);
+    #endif
+      source += 4;
+      dest += drawvars.PITCH;
+   }
+  #else
    while(--count >= 0)
    {
       dest[0] = GETDESTCOLOR(dest[0], source[0]);
@@ -234,6 +258,7 @@ static void R_FLUSHQUAD_FUNCNAME(void)
       source += 4 * sizeof(byte);
       dest += drawvars.PITCH * sizeof(byte);
    }
+  #endif
 #elif (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
    while(--count >= 0)
    {
@@ -268,6 +293,28 @@ static void R_FLUSHQUAD_FUNCNAME(void)
          dest += drawvars.PITCH * sizeof(byte);
       }
    }
+  #elif (R_DRAWCOLUMN_PIPELINE_BITS == 15) || (R_DRAWCOLUMN_PIPELINE_BITS == 16)
+   // the four pixels of a row fit in two words, the source always is
+   // aligned so this only depends on which column the quad starts at
+   if ((sizeof(int) == 4) && (((int)source % 4) == 0) && (((int)dest % 4) == 0)) {
+      while(--count >= 0)
+      {
+         ((int *)dest)[0] = ((int *)source)[0];
+         ((int *)dest)[1] = ((int *)source)[1];
+         source += 4;
+         dest += drawvars.PITCH;
+      }
+   } else {
+      while(--count >= 0)
+      {
+         dest[0] = source[0];
+         dest[1] = source[1];
+         dest[2] = source[2];
+         dest[3] = source[3];
+         source += 4;
+         dest += drawvars.PITCH;
+      }
+   }
   #else
    while(--count >= 0)
    {
@@ -282,6 +329,8 @@ static void R_FLUSHQUAD_FUNCNAME(void)
 #endif
 }
 
+#undef GETSPLITCOLOR16
+#undef GETSPLITCOLOR15
 #undef GETDESTCOLOR32
 #undef GETDESTCOLOR16
 #undef GETDESTCOLOR15
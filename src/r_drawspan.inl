@@ -56,6 +56,11 @@
   #define GETDEPTHMAP(col) colormap[(col)]
 #endif
 
+// as in r_drawcolumn.inl, single colormap 16 bit spans use R_Colormap16
+#if (R_DRAWSPAN_PIPELINE_BITS == 16) && !(R_DRAWSPAN_PIPELINE & (RDC_DITHERZ|RDC_BILINEAR))
+  #define USE_COLORMAP16
+#endif
+
 #if (R_DRAWSPAN_PIPELINE_BITS == 8)
   #define GETCOL_POINT(col) GETDEPTHMAP(col)
   #define GETCOL_LINEAR(col) GETDEPTHMAP(col)
@@ -63,7 +68,11 @@
   #define GETCOL_POINT(col) VID_PAL15(GETDEPTHMAP(col), VID_COLORWEIGHTMASK)
   #define GETCOL_LINEAR(col) filter_getFilteredForSpan15(GETDEPTHMAP, xfrac, yfrac)
 #elif (R_DRAWSPAN_PIPELINE_BITS == 16)
-  #define GETCOL_POINT(col) VID_PAL16(GETDEPTHMAP(col), VID_COLORWEIGHTMASK)
+  #ifdef USE_COLORMAP16
+    #define GETCOL_POINT(col) colormap16[(col)]
+  #else
+    #define GETCOL_POINT(col) VID_PAL16(GETDEPTHMAP(col), VID_COLORWEIGHTMASK)
+  #endif
   #define GETCOL_LINEAR(col) filter_getFilteredForSpan16(GETDEPTHMAP, xfrac, yfrac)
 #elif (R_DRAWSPAN_PIPELINE_BITS == 32)
   #define GETCOL_POINT(col) VID_PAL32(GETDEPTHMAP(col), VID_COLORWEIGHTMASK)
@@ -76,6 +85,48 @@
  #define GETCOL(col) GETCOL_POINT(col)
 #endif
 
+#if (R_DRAWSPAN_PIPELINE & (RDC_DITHERZ|RDC_BILINEAR))
+  #define R_DRAWSPAN_NEXTX x1--
+#else
+  #define R_DRAWSPAN_NEXTX
+#endif
+
+#if ((R_DRAWSPAN_PIPELINE_BITS != 8) && (R_DRAWSPAN_PIPELINE & RDC_BILINEAR))
+  // truecolor bilinear filtered
+  #define R_DRAWSPAN_PIXEL { \
+    *dest++ = GETCOL(0); \
+    xfrac += xstep; \
+    yfrac += ystep; \
+    R_DRAWSPAN_NEXTX; \
+  }
+#elif (R_DRAWSPAN_PIPELINE & RDC_ROUNDED)
+  #define R_DRAWSPAN_PIXEL { \
+    *dest++ = GETCOL(filter_getRoundedForSpan(xfrac, yfrac)); \
+    xfrac += xstep; \
+    yfrac += ystep; \
+    R_DRAWSPAN_NEXTX; \
+  }
+#elif (R_DRAWSPAN_PIPELINE & RDC_BILINEAR)
+  // 8 bit bilinear
+  #define R_DRAWSPAN_PIXEL { \
+    const fixed_t xtemp = ((xfrac >> 16) + (filter_getDitheredPixelLevel(x1, y, ((xfrac>>8)&0xff)))) & 63; \
+    const fixed_t ytemp = ((yfrac >> 10) + 64*(filter_getDitheredPixelLevel(x1, y, ((yfrac>>8)&0xff)))) & 4032; \
+    const fixed_t spot = xtemp | ytemp; \
+    xfrac += xstep; \
+    yfrac += ystep; \
+    *dest++ = GETCOL(source[spot]); \
+    R_DRAWSPAN_NEXTX; \
+  }
+#else
+  #define R_DRAWSPAN_PIXEL { \
+    const fixed_t spot = ((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032); \
+    xfrac += xstep; \
+    yfrac += ystep; \
+    *dest++ = GETCOL(source[spot]); \
+    R_DRAWSPAN_NEXTX; \
+  }
+#endif
+
 static void R_DRAWSPAN_FUNCNAME(draw_span_vars_t *dsvars)
 {
 #if (R_DRAWSPAN_PIPELINE & (RDC_ROUNDED|RDC_BILINEAR))
@@ -97,6 +148,9 @@ static void R_DRAWSPAN_FUNCNAME(draw_span_vars_t *dsvars)
   const fixed_t ystep = dsvars->ystep;
   const byte *source = dsvars->source;
   const byte *colormap = dsvars->colormap;
+#ifdef USE_COLORMAP16
+  const unsigned short *colormap16 = R_Colormap16(colormap);
+#endif
   SCREENTYPE *dest = drawvars.TOPLEFT + dsvars->y*drawvars.PITCH + dsvars->x1;
 #if (R_DRAWSPAN_PIPELINE & (RDC_DITHERZ|RDC_BILINEAR))
   const int y = dsvars->y;
@@ -107,47 +161,30 @@ static void R_DRAWSPAN_FUNCNAME(draw_span_vars_t *dsvars)
   const byte *dither_colormaps[2] = { dsvars->colormap, dsvars->nextcolormap };
 #endif
 
+  // the loop is unrolled by eight, most spans on open maps are long
+  // enough that the per pixel loop overhead is worth cutting
+  while (count >= 8) {
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    R_DRAWSPAN_PIXEL;
+    count -= 8;
+  }
   while (count) {
-#if ((R_DRAWSPAN_PIPELINE_BITS != 8) && (R_DRAWSPAN_PIPELINE & RDC_BILINEAR))
-    // truecolor bilinear filtered
-    *dest++ = GETCOL(0);
-    xfrac += xstep;
-    yfrac += ystep;
-    count--;
-  #if (R_DRAWSPAN_PIPELINE & RDC_DITHERZ)
-    x1--;
-  #endif
-#elif (R_DRAWSPAN_PIPELINE & RDC_ROUNDED)
-    *dest++ = GETCOL(filter_getRoundedForSpan(xfrac, yfrac));
-    xfrac += xstep;
-    yfrac += ystep;
+    R_DRAWSPAN_PIXEL;
     count--;
-  #if (R_DRAWSPAN_PIPELINE & RDC_DITHERZ)
-    x1--;
-  #endif
-#else
-  #if (R_DRAWSPAN_PIPELINE & RDC_BILINEAR)
-    // 8 bit bilinear
-    const fixed_t xtemp = ((xfrac >> 16) + (filter_getDitheredPixelLevel(x1, y, ((xfrac>>8)&0xff)))) & 63;
-    const fixed_t ytemp = ((yfrac >> 10) + 64*(filter_getDitheredPixelLevel(x1, y, ((yfrac>>8)&0xff)))) & 4032;
-  #else
-    const fixed_t xtemp = (xfrac >> 16) & 63;
-    const fixed_t ytemp = (yfrac >> 10) & 4032;
-  #endif
-    const fixed_t spot = xtemp | ytemp;
-    xfrac += xstep;
-    yfrac += ystep;
-    *dest++ = GETCOL(source[spot]);
-    count--;
-  #if (R_DRAWSPAN_PIPELINE & (RDC_DITHERZ|RDC_BILINEAR))
-    x1--;
-  #endif
-#endif
   }
   }
 }
 
+#undef R_DRAWSPAN_PIXEL
+#undef R_DRAWSPAN_NEXTX
 #undef GETDEPTHMAP
+#undef USE_COLORMAP16
 #undef GETCOL_LINEAR
 #undef GETCOL_POINT
 #undef GETCOL
@@ -171,4 +171,19 @@ byte *filter_getScale2xQuadColors(byte e, byte b, byte f, byte h, byte d);
   ((((col1&0xff00ff)*15+(col2&0xff00ff))>>4)&0xff00ff) | \
   ((((col1&0x00ff00)*15+(col2&0x00ff00))>>4)&0x00ff00)
 
+// Split a 15/16 bit pixel so that green sits in the top half of a 32 bit
+// word. Each field then has at least 4 bits of headroom, so all three can
+// be weighted with a single multiply and joined back afterwards. Gives
+// the same result as the GETBLENDED macros above.
+#define SPLIT15(col) ((((unsigned int)(col))|(((unsigned int)(col))<<16))&0x03e07c1f)
+#define SPLIT16(col) ((((unsigned int)(col))|(((unsigned int)(col))<<16))&0x07e0f81f)
+#define JOIN15(col) ((unsigned short)(((col)&0x7c1f)|(((col)>>16)&0x03e0)))
+#define JOIN16(col) ((unsigned short)(((col)&0xf81f)|(((col)>>16)&0x07e0)))
+
+#define GETBLENDED15_3268_SPLIT(col1, col2) \
+  JOIN15((((col1)*5+(col2)*11)>>4)&0x03e07c1f)
+
+#define GETBLENDED16_3268_SPLIT(col1, col2) \
+  JOIN16((((col1)*5+(col2)*11)>>4)&0x07e0f81f)
+
 #endif
@@ -58,6 +58,7 @@
 #include "g_game.h"
 #include "r_demo.h"
 #include "r_fps.h"
+#include "m_bench.h"
 
 // Fineangles in the SCREENWIDTH wide window.
 #define FIELDOFVIEW 2048
@@ -557,9 +558,11 @@ static void R_ShowStats(void)
   {
     doom_printf((V_GetMode() == VID_MODEGL)
                 ?"Frame rate %d fps\nWalls %d, Flats %d, Sprites %d"
-                :"Frame rate %d fps\nSegs %d, Visplanes %d, Sprites %d",
+                :"Frame rate %d fps\nSegs %d, Visplanes %d, Sprites %d\n"
+                 "Plane hash %d, %d probes in %d lookups",
     1000 * FPS_FrameCount / (tick - FPS_SavedTick), rendered_segs,
-    rendered_visplanes, rendered_vissprites);
+    rendered_visplanes, rendered_vissprites,
+    numvisplanebuckets, visplaneprobes, visplanelookups);
     FPS_SavedTick = tick;
     FPS_FrameCount = 0;
   }
@@ -572,9 +575,11 @@ static void R_ShowStats(void)
   if (now - showtime > 35) {
     doom_printf((V_GetMode() == VID_MODEGL)
                 ?"Frame rate %d fps\nWalls %d, Flats %d, Sprites %d"
-                :"Frame rate %d fps\nSegs %d, Visplanes %d, Sprites %d",
+                :"Frame rate %d fps\nSegs %d, Visplanes %d, Sprites %d\n"
+                 "Plane hash %d, %d probes in %d lookups",
     (35*KEEPTIMES)/(now - keeptime[0]), rendered_segs,
-    rendered_visplanes, rendered_vissprites);
+    rendered_visplanes, rendered_vissprites,
+    numvisplanebuckets, visplaneprobes, visplanelookups);
     showtime = now;
   }
   memmove(keeptime, keeptime+1, sizeof(keeptime[0]) * (KEEPTIMES-1));
@@ -606,6 +611,8 @@ void R_RenderPlayerView (player_t* player)
     gld_StartDrawScene();
 #endif
   } else {
+    V_MarkRect(viewwindowx, viewwindowy, viewwidth, viewheight);
+
     if (autodetect_hom)
     { // killough 2/10/98: add flashing red HOM indicators
       unsigned char color=(gametic % 20) < 9 ? 0xb0 : 0;
@@ -620,16 +627,21 @@ void R_RenderPlayerView (player_t* player)
 #endif
 
   // The head node is the last node output.
+  M_BENCH_START(BP_BSP);
   R_RenderBSPNode (numnodes-1);
   R_ResetColumnBuffer();
+  M_BENCH_END(BP_BSP);
 
   // Check for new console commands.
 #ifdef HAVE_NET
   NetUpdate ();
 #endif
 
-  if (V_GetMode() != VID_MODEGL)
+  if (V_GetMode() != VID_MODEGL) {
+    M_BENCH_START(BP_PLANES);
     R_DrawPlanes ();
+    M_BENCH_END(BP_PLANES);
+  }
 
   // Check for new console commands.
 #ifdef HAVE_NET
@@ -637,8 +649,10 @@ void R_RenderPlayerView (player_t* player)
 #endif
 
   if (V_GetMode() != VID_MODEGL) {
+    M_BENCH_START(BP_MASKED);
     R_DrawMasked ();
     R_ResetColumnBuffer();
+    M_BENCH_END(BP_MASKED);
   }
 
   // Check for new console commands.
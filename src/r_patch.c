@@ -40,6 +40,8 @@
 #include "r_draw.h"
 #include "lprintf.h"
 #include "r_patch.h"
+#include "m_argv.h"
+#include "md5.h"
 #include <assert.h>
 #include "brew.h"
 
@@ -76,6 +78,340 @@ static rpatch_t *patches = 0;
 
 static rpatch_t *texture_composites = 0;
 
+//---------------------------------------------------------------------------
+// Persistent patch cache
+//
+// Converted patches and texture composites are appended to
+// <exe dir>/patches.prc and read back on later runs with a single read
+// into their final block, instead of being converted again. Records are
+// the rpatch_t data block as it is in memory, with the column pointers
+// stored as offsets into it. The file is keyed by the MD5 of the size
+// and date of each WAD, the lump directory and the texture definitions,
+// so any change to the loaded WADs starts a new one. -nopatchcache
+// disables it.
+//---------------------------------------------------------------------------
+
+#define PATCHCACHE_MAGIC   0x43505250 // "PRPC"
+#define PATCHCACHE_VERSION 2
+
+typedef struct {
+  unsigned int magic;
+  unsigned int version;
+  unsigned char md5[16];
+  int numlumps, numtextures;
+  int columnsize, postsize;     // layout the records were written with
+} patchcache_t;
+
+typedef struct {
+  int id;                       // lump number, or numlumps + texture number
+  int width, height;
+  unsigned widthmask;
+  int isNotTileable;
+  int leftoffset, topoffset;
+  int dataSize;
+} patchrecord_t;
+
+static boolean patchcache_enabled;
+static patchcache_t patchcache_header;
+static char patchcache_fname[PATH_MAX+1];
+static FILE *patchcache_file;   // open for reading between stores
+static int *patchcache_offsets; // record offset per id, 0 if not stored
+static int patchcache_size;     // bytes in the file
+static int *patchcache_pending; // ids converted but not stored yet
+static int patchcache_numpending, patchcache_maxpending;
+static int patchcache_loads, patchcache_stores;
+
+static void R_PatchCacheHashLump(struct MD5Context *md5, const char *name)
+{
+  int lump = W_CheckNumForName(name);
+
+  if (lump != -1)
+  {
+    MD5Update(md5, W_CacheLumpNum(lump), W_LumpLength(lump));
+    W_UnlockLumpNum(lump);
+  }
+}
+
+// Starts a new, empty cache file, dropping any records of the old one
+static void R_PatchCacheCreate(void)
+{
+  if (patchcache_file)
+    fclose(patchcache_file);
+
+  memset(patchcache_offsets, 0, (numlumps + numtextures) * sizeof *patchcache_offsets);
+  patchcache_size = 0;
+  if ((patchcache_file = fopen(patchcache_fname, "wb")) != NULL)
+  {
+    patchcache_size = sizeof patchcache_header;
+    fwrite(&patchcache_header, sizeof patchcache_header, 1, patchcache_file);
+    fclose(patchcache_file);
+    patchcache_file = fopen(patchcache_fname, "rb");
+  }
+  if (!patchcache_file)
+  {
+    lprintf(LO_WARN, "R_PatchCacheCreate: unable to create %s\n", patchcache_fname);
+    patchcache_enabled = false;
+  }
+}
+
+static void R_PatchCacheOpen(void)
+{
+  struct MD5Context md5;
+  patchcache_t header, want;
+  patchrecord_t rec;
+  struct stat st;
+  int i, offset;
+
+  if (!(patchcache_enabled = !M_CheckParm("-nopatchcache")))
+    return;
+
+  memset(&want, 0, sizeof want);
+  want.magic = PATCHCACHE_MAGIC;
+  want.version = PATCHCACHE_VERSION;
+  want.numlumps = numlumps;
+  want.numtextures = numtextures;
+  want.columnsize = sizeof(rcolumn_t);
+  want.postsize = sizeof(rpost_t);
+
+  // a WAD edited in place keeps its directory but not its size and date
+  MD5Init(&md5);
+  for (i=0; i<numwadfiles; i++)
+  {
+    if (wadfiles[i].handle && fstat(wadfiles[i].handle, &st) != -1)
+    {
+      int info[2];
+
+      info[0] = st.st_size;
+      info[1] = st.st_mtime;
+      MD5Update(&md5, (const unsigned char *)info, sizeof info);
+    }
+  }
+  for (i=0; i<numlumps; i++)
+  {
+    MD5Update(&md5, (const unsigned char *)lumpinfo[i].name, 8);
+    MD5Update(&md5, (const unsigned char *)&lumpinfo[i].size, sizeof(int));
+    MD5Update(&md5, (const unsigned char *)&lumpinfo[i].position, sizeof(int));
+  }
+  R_PatchCacheHashLump(&md5, "PNAMES");
+  R_PatchCacheHashLump(&md5, "TEXTURE1");
+  R_PatchCacheHashLump(&md5, "TEXTURE2");
+  MD5Final(want.md5, &md5);
+
+  patchcache_offsets = calloc(numlumps + numtextures, sizeof *patchcache_offsets);
+  sprintf(patchcache_fname, "%s/patches.prc", I_DoomExeDir());
+
+  patchcache_header = want;
+
+  if ((patchcache_file = fopen(patchcache_fname, "rb")) != NULL)
+  {
+    if (fstat((IFile *)patchcache_file, &st) != -1 &&
+        fread(&header, 1, sizeof header, patchcache_file) == sizeof header &&
+        !memcmp(&header, &want, sizeof want))
+    {
+      // index the records; they must end exactly at the end of the
+      // file, else appending would put the next ones at wrong offsets
+      offset = sizeof header;
+      while (offset < st.st_size &&
+             fread(&rec, 1, sizeof rec, patchcache_file) == sizeof rec &&
+             rec.id >= 0 && rec.id < numlumps + numtextures &&
+             rec.dataSize > 0 && rec.dataSize <= st.st_size - offset - (int)sizeof rec)
+      {
+        patchcache_offsets[rec.id] = offset;
+        offset += sizeof rec + rec.dataSize;
+        fseek(patchcache_file, offset, _SEEK_START);
+      }
+      if (offset == st.st_size)
+      {
+        patchcache_size = offset;
+        lprintf(LO_INFO, "R_PatchCacheOpen: %dk of patches in %s\n",
+                patchcache_size / 1024, patchcache_fname);
+        return;
+      }
+      lprintf(LO_WARN, "R_PatchCacheOpen: %s is damaged, starting over\n",
+              patchcache_fname);
+    }
+  }
+
+  // no usable cache, start a new one
+  R_PatchCacheCreate();
+}
+
+// Converts the column pointers of a patch to offsets into its data
+// block or back
+static void R_PatchCacheRelocate(rpatch_t *patch, boolean tooffsets)
+{
+  int x;
+
+  for (x=0; x<patch->width; x++)
+  {
+    rcolumn_t *column = &patch->columns[x];
+
+    if (tooffsets)
+    {
+      column->pixels = (unsigned char *)(column->pixels - patch->data);
+      column->posts = (rpost_t *)((unsigned char *)column->posts - patch->data);
+    }
+    else
+    {
+      column->pixels = patch->data + (size_t)column->pixels;
+      column->posts = (rpost_t *)(patch->data + (size_t)column->posts);
+    }
+  }
+}
+
+// Returns true if the column offsets of a data block just read from
+// the cache all lie inside it, so relocating them gives pointers the
+// column drawers can follow
+static boolean R_PatchCacheCheck(const rpatch_t *patch, int dataSize)
+{
+  const int pixelDataSize = (patch->width * patch->height + 4) & ~3;
+  int x;
+
+  for (x=0; x<patch->width; x++)
+  {
+    const rcolumn_t *column = &patch->columns[x];
+    const size_t pixels = (size_t)column->pixels;
+    const size_t posts = (size_t)column->posts;
+
+    if (pixels + patch->height > (size_t)pixelDataSize ||
+        column->numPosts < 0 || posts % sizeof(int) || posts > (size_t)dataSize ||
+        (dataSize - posts) / sizeof(rpost_t) < (size_t)column->numPosts)
+      return false;
+  }
+  return true;
+}
+
+// Fills in patch from the cache, returns false if it is not stored
+static boolean R_PatchCacheLoad(rpatch_t *patch, int id, int tag)
+{
+  patchrecord_t rec;
+  int pixelDataSize;
+
+  if (!patchcache_enabled || !patchcache_offsets[id])
+    return false;
+
+  fseek(patchcache_file, patchcache_offsets[id], _SEEK_START);
+  if (fread(&rec, 1, sizeof rec, patchcache_file) != sizeof rec || rec.id != id ||
+      rec.width <= 0 || rec.width > MAX_SCREENWIDTH*4 ||
+      rec.height <= 0 || rec.height > MAX_SCREENHEIGHT*4 ||
+      rec.dataSize < ((rec.width * rec.height + 4) & ~3) +
+                     rec.width * (int)sizeof(rcolumn_t))
+  {
+    R_PatchCacheCreate();
+    return false;
+  }
+
+  patch->width = rec.width;
+  patch->height = rec.height;
+  patch->widthmask = rec.widthmask;
+  patch->isNotTileable = rec.isNotTileable;
+  patch->leftoffset = rec.leftoffset;
+  patch->topoffset = rec.topoffset;
+
+  patch->data = (unsigned char*)Z_Malloc(rec.dataSize, tag, (void **)&patch->data);
+  pixelDataSize = (patch->width * patch->height + 4) & ~3;
+  patch->pixels = patch->data;
+  patch->columns = (rcolumn_t*)(patch->data + pixelDataSize);
+  patch->posts = (rpost_t*)((unsigned char*)patch->columns + sizeof(rcolumn_t) * patch->width);
+
+  if (fread(patch->data, 1, rec.dataSize, patchcache_file) != (size_t)rec.dataSize ||
+      !R_PatchCacheCheck(patch, rec.dataSize))
+  {
+    Z_Free(patch->data);
+    patch->data = NULL;
+    R_PatchCacheCreate();
+    return false;
+  }
+  R_PatchCacheRelocate(patch, false);
+
+  patchcache_loads++;
+  return true;
+}
+
+// Remembers a freshly converted patch for R_StorePatchCache
+static void R_PatchCacheAdd(int id)
+{
+  if (!patchcache_enabled)
+    return;
+
+  if (patchcache_numpending == patchcache_maxpending)
+  {
+    patchcache_maxpending = patchcache_maxpending ? patchcache_maxpending*2 : 128;
+    patchcache_pending = realloc(patchcache_pending,
+                                 patchcache_maxpending * sizeof *patchcache_pending);
+  }
+  patchcache_pending[patchcache_numpending++] = id;
+}
+
+//
+// R_StorePatchCache
+// Appends the patches converted since the last call to the cache file.
+// Ones the zone purged meanwhile are left for a later run.
+//
+void R_StorePatchCache(void)
+{
+  FILE *f;
+  int i;
+
+  if (!patchcache_enabled || !patchcache_numpending)
+    return;
+
+  // BREW can't have the file open twice, reopen it for appending
+  fclose(patchcache_file);
+  if ((f = fopen(patchcache_fname, "a")) != NULL)
+  {
+    for (i=0; i<patchcache_numpending; i++)
+    {
+      const int id = patchcache_pending[i];
+      rpatch_t *patch = id < numlumps ? &patches[id] : &texture_composites[id - numlumps];
+      patchrecord_t rec;
+
+      if (!patch->data || patchcache_offsets[id])
+        continue;
+
+      rec.id = id;
+      rec.width = patch->width;
+      rec.height = patch->height;
+      rec.widthmask = patch->widthmask;
+      rec.isNotTileable = patch->isNotTileable;
+      rec.leftoffset = patch->leftoffset;
+      rec.topoffset = patch->topoffset;
+      {
+        // the block ends after the posts of the last column, which keeps
+        // its place when merging posts lowers the counts of the ones before
+        int x;
+        rec.dataSize = (unsigned char*)patch->posts - patch->data;
+        for (x=0; x<patch->width; x++)
+        {
+          const rcolumn_t *column = &patch->columns[x];
+          int end = (unsigned char*)(column->posts + column->numPosts) - patch->data;
+          if (end > rec.dataSize)
+            rec.dataSize = end;
+        }
+      }
+
+      R_PatchCacheRelocate(patch, true);
+      fwrite(&rec, sizeof rec, 1, f);
+      fwrite(patch->data, rec.dataSize, 1, f);
+      R_PatchCacheRelocate(patch, false);
+
+      patchcache_offsets[id] = patchcache_size;
+      patchcache_size += sizeof rec + rec.dataSize;
+      patchcache_stores++;
+    }
+    fclose(f);
+  }
+  else
+    lprintf(LO_WARN, "R_StorePatchCache: unable to write %s\n", patchcache_fname);
+
+  lprintf(LO_INFO, "R_StorePatchCache: %d patches loaded, %d stored, %dk in cache\n",
+          patchcache_loads, patchcache_stores, patchcache_size / 1024);
+  patchcache_numpending = 0;
+
+  if (!(patchcache_file = fopen(patchcache_fname, "rb")))
+    patchcache_enabled = false;
+}
+
 //---------------------------------------------------------------------------
 void R_InitPatches(void) {
   if (!patches)
@@ -90,6 +426,8 @@ void R_InitPatches(void) {
     // clear out new patches to signal they're uninitialized
     memset(texture_composites, 0, sizeof(rpatch_t)*numtextures);
   }
+  if (!patchcache_offsets)
+    R_PatchCacheOpen();
 }
 
 //---------------------------------------------------------------------------
@@ -678,8 +1016,11 @@ const rpatch_t *R_CachePatchNumC(int id, const char *caller) {
     I_Error("createPatch: %i >= numlumps", id);
 #endif
 
-  if (!patches[id].data)
+  if (!patches[id].data && !R_PatchCacheLoad(&patches[id], id, PU_CACHE))
+  {
     createPatch(id);
+    R_PatchCacheAdd(id);
+  }
 
   /* cph - if wasn't locked but now is, tell z_zone to hold it */
   if (!patches[id].locks && locks) {
@@ -727,8 +1068,12 @@ const rpatch_t *R_CacheTextureCompositePatchNum(int id) {
     I_Error("createTextureCompositePatch: %i >= numtextures", id);
 #endif
 
-  if (!texture_composites[id].data)
+  if (!texture_composites[id].data &&
+      !R_PatchCacheLoad(&texture_composites[id], numlumps + id, PU_STATIC))
+  {
     createTextureCompositePatch(id);
+    R_PatchCacheAdd(numlumps + id);
+  }
 
   /* cph - if wasn't locked but now is, tell z_zone to hold it */
   if (!texture_composites[id].locks && locks) {
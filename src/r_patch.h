@@ -108,4 +108,7 @@ const rcolumn_t *R_GetPatchColumn(const rpatch_t *patch, int columnIndex);
 void R_InitPatches();
 void R_FlushAllPatches();
 
+// Appends patches converted since the last call to the patch cache file
+void R_StorePatchCache(void);
+
 #endif
@@ -36,6 +36,9 @@
  * better performance usually but after a point they are wasted,
  * and memory and time overheads creep in.
  *
+ * The number of hash slots now starts at MINVISPLANES and grows with
+ * the number of planes the level actually produces.
+ *
  * For more information on visplanes, see:
  *
  * http://classicgaming.com/doom/editing/
@@ -60,18 +63,28 @@
 #include "v_video.h"
 #include "lprintf.h"
 
-#define MAXVISPLANES 128    /* must be a power of 2 */
+#define MINVISPLANES 128    /* must be a power of 2 */
+
+// The hash table starts at MINVISPLANES buckets and doubles at the start
+// of a frame whenever the previous one averaged more than two planes
+// per bucket, so detailed maps keep short chains without a large table
+// on every map.
 
-static visplane_t *visplanes[MAXVISPLANES];   // killough
+static visplane_t **visplanes;                // killough
 static visplane_t *freetail;                  // killough
 static visplane_t **freehead = &freetail;     // killough
 visplane_t *floorplane, *ceilingplane;
 
+int numvisplanebuckets;
+int numvisplanes, visplanelookups, visplaneprobes;
+
 // killough -- hash function for visplanes
 // Empirically verified to be fairly uniform:
+// Heights are hashed by their integer part, their fractional bits are
+// nearly always zero and would leave height out of the hash entirely.
 
 #define visplane_hash(picnum,lightlevel,height) \
-  ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & (MAXVISPLANES-1))
+  ((unsigned)((picnum)*3+(lightlevel)+((height)>>FRACBITS)*7) & (numvisplanebuckets-1))
 
 size_t maxopenings;
 int *openings,*lastopening; // dropoff overflow
@@ -101,6 +114,7 @@ static fixed_t cacheddistance[MAX_SCREENHEIGHT];
 static fixed_t cachedxstep[MAX_SCREENHEIGHT];
 static fixed_t cachedystep[MAX_SCREENHEIGHT];
 static fixed_t xoffs,yoffs;    // killough 2/28/98: flat offsets
+static R_DrawSpan_f spanfunc;  // looked up once per plane
 
 fixed_t yslope[MAX_SCREENHEIGHT], distscale[MAX_SCREENWIDTH];
 
@@ -110,6 +124,8 @@ fixed_t yslope[MAX_SCREENHEIGHT], distscale[MAX_SCREENWIDTH];
 //
 void R_InitPlanes (void)
 {
+  numvisplanebuckets = MINVISPLANES;
+  visplanes = calloc(numvisplanebuckets, sizeof *visplanes);
 }
 
 //
@@ -183,8 +199,7 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
   dsvars->x1 = x1;
   dsvars->x2 = x2;
 
-  if (V_GetMode() != VID_MODEGL)
-    R_DrawSpan(dsvars);
+  spanfunc(dsvars);
 }
 
 //
@@ -200,10 +215,22 @@ void R_ClearPlanes(void)
   for (i=0 ; i<viewwidth ; i++)
     floorclip[i] = viewheight, ceilingclip[i] = -1;
 
-  for (i=0;i<MAXVISPLANES;i++)    // new code -- killough
+  for (i=0;i<numvisplanebuckets;i++)    // new code -- killough
     for (*freehead = visplanes[i], visplanes[i] = NULL; *freehead; )
       freehead = &(*freehead)->next;
 
+  // all planes are on the free list now, so the table can be resized
+  if (numvisplanes > numvisplanebuckets*2)
+  {
+    while (numvisplanes > numvisplanebuckets*2)
+      numvisplanebuckets *= 2;
+    free(visplanes);
+    visplanes = calloc(numvisplanebuckets, sizeof *visplanes);
+    lprintf(LO_DEBUG, "R_ClearPlanes: %d visplane hash buckets for %d planes\n",
+            numvisplanebuckets, numvisplanes);
+  }
+  numvisplanes = visplanelookups = visplaneprobes = 0;
+
   lastopening = openings;
 
   // texture calculation
@@ -226,6 +253,7 @@ static visplane_t *new_visplane(unsigned hash)
       freehead = &freetail;
   check->next = visplanes[hash];
   visplanes[hash] = check;
+  numvisplanes++;
   return check;
 }
 
@@ -265,8 +293,9 @@ visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel,
 
   // New visplane algorithm uses hash table -- killough
   hash = visplane_hash(picnum,lightlevel,height);
+  visplanelookups++;
 
-  for (check=visplanes[hash]; check; check=check->next)  // killough
+  for (check=visplanes[hash]; check; check=check->next, visplaneprobes++)  // killough
     if (height == check->height &&
         picnum == check->picnum &&
         lightlevel == check->lightlevel &&
@@ -442,6 +471,7 @@ static void R_DoDrawPlane(visplane_t *pl)
 
       stop = pl->maxx + 1;
       planezlight = zlight[light];
+      spanfunc = R_GetDrawSpanFunc(drawvars.filterfloor, drawvars.filterz);
       pl->top[pl->minx-1] = pl->top[stop] = 0xffffffffu; // dropoff overflow
 
       for (x = pl->minx ; x <= stop ; x++)
@@ -462,7 +492,7 @@ void R_DrawPlanes (void)
 {
   visplane_t *pl;
   int i;
-  for (i=0;i<MAXVISPLANES;i++)
+  for (i=0;i<numvisplanebuckets;i++)
     for (pl=visplanes[i]; pl; pl=pl->next, rendered_visplanes++)
       R_DoDrawPlane(pl);
 }
@@ -49,6 +49,10 @@ extern int *lastopening; // dropoff overflow
 extern int floorclip[], ceilingclip[]; // dropoff overflow
 extern fixed_t yslope[], distscale[];
 
+/* Visplane hash size and chain statistics of the current frame */
+extern int numvisplanebuckets;
+extern int numvisplanes, visplanelookups, visplaneprobes;
+
 void R_InitPlanes(void);
 void R_ClearPlanes(void);
 void R_DrawPlanes (void);
@@ -63,6 +63,11 @@ angle_t         rw_normalangle; // angle to line origin
 int             rw_angle1;
 fixed_t         rw_distance;
 
+// Set up walls from the per-seg direction vectors instead of
+// R_PointToDist. Differs from vanilla in the last bits, so it is not
+// used at vanilla compatibility levels.
+int             render_fastwalls = 1;
+
 //
 // regular wall
 //
@@ -476,6 +481,7 @@ void R_StoreWallRange(const int start, const int stop)
 {
   fixed_t hyp;
   angle_t offsetangle;
+  fixed_t segoffset;
 
   if (ds_p == drawsegs+maxdrawsegs)   // killough 1/98 -- fix 2s line HOM
     {
@@ -520,9 +526,25 @@ void R_StoreWallRange(const int start, const int stop)
   if (D_abs(offsetangle) > ANG90)
     offsetangle = ANG90;
 
-  hyp = (viewx==curline->v1->x && viewy==curline->v1->y)?
-    0 : R_PointToDist (curline->v1->x, curline->v1->y);
-  rw_distance = FixedMul(hyp, finecosine[offsetangle>>ANGLETOFINESHIFT]);
+  if (render_fastwalls && !demo_compatibility)
+    {
+      // project the viewer onto the seg and its normal instead of
+      // dividing for the distance to v1, then taking it apart by angle
+      const int_64_t dx = (int_64_t)viewx - curline->v1->x;
+      const int_64_t dy = (int_64_t)viewy - curline->v1->y;
+
+      rw_distance = (fixed_t)((dx * curline->diry - dy * curline->dirx) >> FRACBITS);
+      if (rw_distance < 0)
+        rw_distance = 0;
+      segoffset = (fixed_t)((dx * curline->dirx + dy * curline->diry) >> FRACBITS);
+    }
+  else
+    {
+      hyp = (viewx==curline->v1->x && viewy==curline->v1->y)?
+        0 : R_PointToDist (curline->v1->x, curline->v1->y);
+      rw_distance = FixedMul(hyp, finecosine[offsetangle>>ANGLETOFINESHIFT]);
+      segoffset = FixedMul (hyp, -finesine[offsetangle >>ANGLETOFINESHIFT]);
+    }
 
   ds_p->x1 = rw_x = start;
   ds_p->x2 = stop;
@@ -733,9 +755,7 @@ void R_StoreWallRange(const int start, const int stop)
 
   if (segtextured)
     {
-      rw_offset = FixedMul (hyp, -finesine[offsetangle >>ANGLETOFINESHIFT]);
-
-      rw_offset += sidedef->textureoffset + curline->offset;
+      rw_offset = segoffset + sidedef->textureoffset + curline->offset;
 
       rw_centerangle = ANG90 + viewangle - rw_normalangle;
 
@@ -41,4 +41,6 @@
 void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2);
 void R_StoreWallRange(const int start, const int stop);
 
+extern int render_fastwalls;
+
 #endif
@@ -855,49 +855,87 @@ void R_DrawPlayerSprites(void)
 
 #endif
 
-// killough 9/2/98: merge sort
+// Sprites are sorted by scale with an LSD radix sort, which is linear
+// in the number of sprites and stable. Sprites of equal scale must come
+// out in the same order killough's merge sort (9/2/98) put them in, or
+// overlapping sprites would draw differently and change the frame hashes of
+// -framehash runs. That sort keeps equal keys in index order inside
+// runs of under 16 and puts the later run first at every merge, so the
+// input is laid out in that order before sorting: the runs from the last
+// to the first, each in index order.
 
-static void msort(vissprite_t **s, vissprite_t **t, int n)
+#define SORT_MINRADIX 64  // below this an insertion sort is cheaper
+
+static unsigned int *vissprite_keys;  // twice num_vissprite_ptrs, like the pointers
+
+static vissprite_t **R_OrderSpriteRuns(vissprite_t **d, int first, int n)
 {
   if (n >= 16)
     {
-      int n1 = n/2, n2 = n - n1;
-      vissprite_t **s1 = s, **s2 = s + n1, **d = t;
-
-      msort(s1, t, n1);
-      msort(s2, t, n2);
-
-      while ((*s1)->scale > (*s2)->scale ?
-             (*d++ = *s1++, --n1) : (*d++ = *s2++, --n2));
+      int n1 = n/2;
+      d = R_OrderSpriteRuns(d, first + n1, n - n1);
+      return R_OrderSpriteRuns(d, first, n1);
+    }
+  while (n--)
+    *d++ = vissprites + first++;
+  return d;
+}
 
-      if (n2)
-        bcopyp(d, s2, n2);
-      else
-        bcopyp(d, s1, n1);
+static void R_RadixSortVisSprites(vissprite_t **s, vissprite_t **t, int n)
+{
+  static unsigned int counts[4][256];
+  unsigned int *keys = vissprite_keys, *tkeys = vissprite_keys + n;
+  int i, pass;
 
-      bcopyp(s, t, n);
+  // flip the sign bit and invert, so ascending keys are descending scales
+  memset(counts, 0, sizeof counts);
+  for (i = 0; i < n; i++)
+    {
+      unsigned int key = ~((unsigned int)s[i]->scale ^ 0x80000000);
+      keys[i] = key;
+      counts[0][key & 0xff]++;
+      counts[1][(key >> 8) & 0xff]++;
+      counts[2][(key >> 16) & 0xff]++;
+      counts[3][key >> 24]++;
     }
-  else
+
+  for (pass = 0; pass < 4; pass++)
     {
-      int i;
-      for (i = 1; i < n; i++)
+      const int shift = pass*8;
+      unsigned int *count = counts[pass], sum = 0;
+
+      // a digit all keys share leaves the order as it is
+      if (count[(keys[0] >> shift) & 0xff] == (unsigned int)n)
+        continue;
+
+      for (i = 0; i < 256; i++)
         {
-          vissprite_t *temp = s[i];
-          if (s[i-1]->scale < temp->scale)
-            {
-              int j = i;
-              while ((s[j] = s[j-1])->scale < temp->scale && --j);
-              s[j] = temp;
-            }
+          unsigned int c = count[i];
+          count[i] = sum;
+          sum += c;
+        }
+
+      for (i = 0; i < n; i++)
+        {
+          unsigned int j = count[(keys[i] >> shift) & 0xff]++;
+          tkeys[j] = keys[i];
+          t[j] = s[i];
         }
+
+      { unsigned int *k = keys; keys = tkeys; tkeys = k; }
+      { vissprite_t **p = s; s = t; t = p; }
     }
+
+  // an odd number of passes left the result in the scratch half
+  if (s != vissprite_ptrs)
+    bcopyp(vissprite_ptrs, s, n);
 }
 
 void R_SortVisSprites (void)
 {
   if (num_vissprite)
     {
-      int i = num_vissprite;
+      const int n = num_vissprite;
 
       // If we need to allocate more pointers for the vissprites,
       // allocate as many as were allocated for sprites -- killough
@@ -908,16 +946,91 @@ void R_SortVisSprites (void)
           free(vissprite_ptrs);  // better than realloc -- no preserving needed
           vissprite_ptrs = malloc((num_vissprite_ptrs = num_vissprite_alloc*2)
                                   * sizeof *vissprite_ptrs);
+          free(vissprite_keys);
+          vissprite_keys = malloc(num_vissprite_ptrs * sizeof *vissprite_keys);
         }
 
-      while (--i>=0)
-        vissprite_ptrs[i] = vissprites+i;
+      R_OrderSpriteRuns(vissprite_ptrs, 0, n);
 
-      // killough 9/22/98: replace qsort with merge sort, since the keys
-      // are roughly in order to begin with, due to BSP rendering.
+      if (n >= SORT_MINRADIX)
+        R_RadixSortVisSprites(vissprite_ptrs, vissprite_ptrs + n, n);
+      else
+        {
+          // stable insertion sort, the runs are nearly in order already
+          // due to BSP rendering
+          int i;
+          for (i = 1; i < n; i++)
+            {
+              vissprite_t *temp = vissprite_ptrs[i];
+              int j = i;
+              while (j && vissprite_ptrs[j-1]->scale < temp->scale)
+                {
+                  vissprite_ptrs[j] = vissprite_ptrs[j-1];
+                  j--;
+                }
+              vissprite_ptrs[j] = temp;
+            }
+        }
+    }
+}
+
+//
+// Drawseg index
+//
+// The screen is split into buckets of 16 columns, each holding a bitmap
+// of the drawsegs that can clip a sprite there, so R_DrawSprite only
+// visits the drawsegs over its own columns instead of all of them. The
+// bitmaps are walked from the highest bit down, which keeps the back to
+// front order the masked mid textures are drawn in.
+//
+
+#define DS_BUCKETSHIFT 4
+
+static unsigned int *dsbuckets;   // bitmap per bucket, dsbucketwords each
+static int dsbucketwords;
+static size_t dsbucketsalloc;
 
-      msort(vissprite_ptrs, vissprite_ptrs + num_vissprite, num_vissprite);
+static void R_BuildDrawSegIndex(void)
+{
+  const int numbuckets = (viewwidth + (1 << DS_BUCKETSHIFT) - 1) >> DS_BUCKETSHIFT;
+  size_t needed;
+  drawseg_t *ds;
+
+  dsbucketwords = ((ds_p - drawsegs) + 31) >> 5;
+  if (!dsbucketwords)
+    return;   // no drawsegs, R_DrawSprite visits no words
+  needed = numbuckets * dsbucketwords;
+
+  if (needed > dsbucketsalloc)
+    {
+      free(dsbuckets);  // no preserving needed
+      dsbuckets = malloc((dsbucketsalloc = needed*2) * sizeof *dsbuckets);
     }
+  memset(dsbuckets, 0, needed * sizeof *dsbuckets);
+
+  for (ds = drawsegs; ds < ds_p; ds++)
+    if (ds->silhouette || ds->maskedtexturecol)
+      {
+        const int i = ds - drawsegs;
+        const unsigned int bit = 1u << (i & 31);
+        unsigned int *word = dsbuckets + (i >> 5);
+        int b;
+
+        for (b = ds->x1 >> DS_BUCKETSHIFT; b <= ds->x2 >> DS_BUCKETSHIFT; b++)
+          word[b * dsbucketwords] |= bit;
+      }
+}
+
+static int R_HighBit(unsigned int x)
+{
+  int bit = 0;
+
+  if (x & 0xffff0000) bit += 16, x >>= 16;
+  if (x & 0xff00)     bit += 8,  x >>= 8;
+  if (x & 0xf0)       bit += 4,  x >>= 4;
+  if (x & 0xc)        bit += 2,  x >>= 2;
+  if (x & 0x2)        bit += 1;
+  return bit;
 }
 
 //
@@ -934,6 +1047,9 @@ static void R_DrawSprite (vissprite_t* spr)
   int     r2;
   fixed_t scale;
   fixed_t lowscale;
+  const unsigned int *firstbucket = dsbuckets + (spr->x1 >> DS_BUCKETSHIFT) * dsbucketwords;
+  const unsigned int *lastbucket = dsbuckets + (spr->x2 >> DS_BUCKETSHIFT) * dsbucketwords;
+  int     w;
 
   for (x = spr->x1 ; x<=spr->x2 ; x++)
     clipbot[x] = cliptop[x] = -2;
@@ -947,15 +1063,25 @@ static void R_DrawSprite (vissprite_t* spr)
 
   //    for (ds=ds_p-1 ; ds >= drawsegs ; ds--)    old buggy code
 
-  for (ds=ds_p ; ds-- > drawsegs ; )  // new -- killough
-    {      // determine if the drawseg obscures the sprite
-      if(ds == NULL) {
-        printf("R_DrawSprite ds is NULL");
-        continue;
-      }
+  // Only the drawsegs indexed in the buckets under the sprite are
+  // visited, still from end to start
+  for (w = dsbucketwords; w-- > 0; )
+  {
+    const unsigned int *bucket;
+    unsigned int bits = 0;
 
-      if (ds->x1 > spr->x2 || ds->x2 < spr->x1 ||
-          (!ds->silhouette && !ds->maskedtexturecol))
+    for (bucket = firstbucket + w; bucket <= lastbucket + w; bucket += dsbucketwords)
+      bits |= *bucket;
+
+    while (bits)
+    {
+      const int bit = R_HighBit(bits);
+
+      bits &= ~(1u << bit);
+      ds = drawsegs + (w << 5) + bit;
+
+      // determine if the drawseg obscures the sprite
+      if (ds->x1 > spr->x2 || ds->x2 < spr->x1)
         continue;      // does not cover sprite
 
       r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
@@ -993,6 +1119,7 @@ static void R_DrawSprite (vissprite_t* spr)
           if (cliptop[x] == -2)
             cliptop[x] = ds->sprtopclip[x];
     }
+  }
 
   // killough 3/27/98:
   // Clip the sprite against deep water and/or fake ceilings.
@@ -1063,6 +1190,7 @@ void R_DrawMasked(void)
   drawseg_t *ds;
 
   R_SortVisSprites();
+  R_BuildDrawSegIndex();
 
   // draw all vissprites back to front
 
@@ -54,6 +54,29 @@ const byte *colrngs[CR_LIMIT];
 
 int usegamma;
 
+// Rows of screen 0 written since the last I_FinishUpdate
+byte V_DirtyRows[MAX_SCREENHEIGHT];
+
+//
+// V_MarkRect
+//
+// Marks the rows covered by a screen 0 rectangle dirty, clipped to the
+// screen. Only rows are tracked: the display texture is updated in whole
+// row bands, as GLES 1.x cannot upload a sub-rectangle of a pitched buffer.
+//
+void V_MarkRect(int x, int y, int width, int height)
+{
+  if (y < 0)
+  {
+    height += y;
+    y = 0;
+  }
+  if (y + height > SCREENHEIGHT)
+    height = SCREENHEIGHT - y;
+  if (width > 0 && height > 0)
+    memset(V_DirtyRows + y, 1, height);
+}
+
 /*
  * V_InitColorTranslation
  *
@@ -138,6 +161,9 @@ static void FUNC_V_CopyRect(int srcx, int srcy, int srcscrn, int width,
     I_Error ("V_CopyRect: Bad arguments");
 #endif
 
+  if (destscrn == 0)
+    V_MarkRect(destx, desty, width, height);
+
   src = screens[srcscrn].data+screens[srcscrn].byte_pitch*srcy+srcx*V_GetPixelDepth();
   dest = screens[destscrn].data+screens[destscrn].byte_pitch*desty+destx*V_GetPixelDepth();
 
@@ -212,6 +238,9 @@ static void FUNC_V_DrawBackground(const char* flatname, int scrn)
   }
   /* end V_DrawBlock */
 
+  if (scrn == 0)
+    V_MarkRect(0, 0, SCREENWIDTH, SCREENHEIGHT);
+
   for (y=0 ; y<SCREENHEIGHT ; y+=64)
     for (x=y ? 0 : 64; x<SCREENWIDTH ; x+=64)
       V_CopyRect(0, 0, scrn, ((SCREENWIDTH-x) < 64) ? (SCREENWIDTH-x) : 64,
@@ -298,6 +327,9 @@ static void V_DrawMemPatch(int x, int y, int scrn, const rpatch_t *patch,
       return;
     }
 
+    if (scrn == 0)
+      V_MarkRect(x, y, patch->width, patch->height);
+
     w--; // CPhipps - note: w = width-1 now, speeds up flipping
 
     for (col=0 ; (unsigned int)col<=w ; desttop++, col++, x++) {
@@ -409,6 +441,9 @@ static void V_DrawMemPatch(int x, int y, int scrn, const rpatch_t *patch,
     right = ( (x + patch->width) * DX ) >> FRACBITS;
     bottom = ( (y + patch->height) * DY ) >> FRACBITS;
 
+    if (scrn == 0)
+      V_MarkRect(left, top, right - left, bottom - top);
+
     dcvars.texheight = patch->height;
     dcvars.iscale = DYI;
     dcvars.drawingmasked = MAX(patch->width, patch->height) > 8;
@@ -505,6 +540,7 @@ static void FUNC_V_DrawNumPatch(int x, int y, int scrn, int lump,
 unsigned short *V_Palette15 = NULL;
 unsigned short *V_Palette16 = NULL;
 unsigned int *V_Palette32 = NULL;
+unsigned int V_PaletteGeneration = 0;
 static unsigned short *Palettes15 = NULL;
 static unsigned short *Palettes16 = NULL;
 static unsigned int *Palettes32 = NULL;
@@ -634,6 +670,7 @@ void V_UpdateTrueColorPalette(video_mode_t mode) {
     }
     V_Palette15 = Palettes15 + paletteNum*256*VID_NUMCOLORWEIGHTS;
   }       
+  V_PaletteGeneration++;
    
   W_UnlockLumpNum(pplump);
   W_UnlockLumpNum(gtlump);
@@ -659,6 +696,7 @@ static void V_DestroyTrueColorPalette(video_mode_t mode) {
     Palettes32 = NULL;
     V_Palette32 = NULL;
   }
+  V_PaletteGeneration++;
 }
 
 void V_DestroyUnusedTrueColorPalettes(void) {
@@ -700,6 +738,10 @@ void V_SetPalette(int pal)
 static void V_FillRect8(int scrn, int x, int y, int width, int height, byte colour)
 {
   byte* dest = screens[scrn].data + x + y*screens[scrn].byte_pitch;
+
+  if (scrn == 0)
+    V_MarkRect(x, y, width, height);
+
   while (height--) {
     memset(dest, colour, width);
     dest += screens[scrn].byte_pitch;
@@ -711,6 +753,10 @@ static void V_FillRect15(int scrn, int x, int y, int width, int height, byte col
   unsigned short* dest = (unsigned short *)screens[scrn].data + x + y*screens[scrn].short_pitch;
   int w;
   short c = VID_PAL15(colour, VID_COLORWEIGHTMASK);
+
+  if (scrn == 0)
+    V_MarkRect(x, y, width, height);
+
   while (height--) {
     for (w=0; w<width; w++) {
       dest[w] = c;
@@ -724,6 +770,10 @@ static void V_FillRect16(int scrn, int x, int y, int width, int height, byte col
   unsigned short* dest = (unsigned short *)screens[scrn].data + x + y*screens[scrn].short_pitch;
   int w;
   short c = VID_PAL16(colour, VID_COLORWEIGHTMASK);
+
+  if (scrn == 0)
+    V_MarkRect(x, y, width, height);
+
   while (height--) {
     for (w=0; w<width; w++) {
       dest[w] = c;
@@ -737,6 +787,10 @@ static void V_FillRect32(int scrn, int x, int y, int width, int height, byte col
   unsigned int* dest = (unsigned int *)screens[scrn].data + x + y*screens[scrn].int_pitch;
   int w;
   int c = VID_PAL32(colour, VID_COLORWEIGHTMASK);
+
+  if (scrn == 0)
+    V_MarkRect(x, y, width, height);
+
   while (height--) {
     for (w=0; w<width; w++) {
       dest[w] = c;
@@ -1001,6 +1055,8 @@ static void WRAP_V_DrawLine(fline_t* fl, int color)
 
 #define PUTDOT(xx,yy,cc) V_PlotPixel(0,xx,yy,(byte)cc)
 
+  V_MarkRect(0, MIN(fl->a.y, fl->b.y), SCREENWIDTH, D_abs(fl->b.y - fl->a.y) + 1);
+
   dx = fl->b.x - fl->a.x;
   ax = 2 * (dx<0 ? -dx : dx);
   sx = dx<0 ? -1 : 1;
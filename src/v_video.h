@@ -89,6 +89,13 @@ typedef struct {
 extern screeninfo_t screens[NUM_SCREENS];
 extern int          usegamma;
 
+// Dirty row tracking for screen 0. Drawers mark the rows they touch so
+// I_FinishUpdate only has to send those rows to the display.
+extern byte V_DirtyRows[MAX_SCREENHEIGHT];
+
+// V_MarkRect - marks a screen 0 rectangle as changed since the last blit
+void V_MarkRect(int x, int y, int width, int height);
+
 // Varying bit-depth support -POPE
 //
 // For bilinear filtering, each palette color is pre-weighted and put in a
@@ -106,6 +113,10 @@ extern unsigned short *V_Palette15;
 extern unsigned short *V_Palette16;
 extern unsigned int *V_Palette32;
 
+// Bumped whenever the palettes above are rebuilt or switched, so tables
+// derived from them know when to follow
+extern unsigned int V_PaletteGeneration;
+
 #define VID_PAL15(color, weight) V_Palette15[ (color)*VID_NUMCOLORWEIGHTS + (weight) ]
 #define VID_PAL16(color, weight) V_Palette16[ (color)*VID_NUMCOLORWEIGHTS + (weight) ]
 #define VID_PAL32(color, weight) V_Palette32[ (color)*VID_NUMCOLORWEIGHTS + (weight) ]
@@ -0,0 +1,132 @@
+/*
+ *  SPDX-FileCopyrightText: Copyright 2012-2023 Fausto "O3" Ribeiro | OpenZeebo <zeebo@tripleoxygen.net>
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Lump cache that reads every WAD file into memory with a single read at
+// startup, selected with WADCACHE=image. Lumps are then returned as
+// pointers into that image, so caching a lump never seeks, allocates or
+// copies, and locking only keeps a count. This trades the size of the
+// WADs in RAM for the thousands of small reads w_memcache.c does while
+// starting up and loading levels.
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "doomstat.h"
+#include "doomtype.h"
+
+#include "w_wad.h"
+#include "z_zone.h"
+#include "lprintf.h"
+#include "i_system.h"
+#include "brew.h"
+
+static int *lumplocks;
+static byte **wadimage;
+
+#ifdef HEAPDUMP
+void W_PrintLump(FILE* fp, void* p) {
+  int i;
+  for (i=0; i<numlumps; i++)
+    if (W_CacheLumpNum(i) == p) {
+      fprintf(fp, " %8.8s %6u %2d", lumpinfo[i].name,
+        W_LumpLength(i), lumplocks[i]);
+      return;
+    }
+  fprintf(fp, " not found");
+}
+#endif
+
+void W_InitCache(void)
+{
+  size_t i;
+
+  lumplocks = calloc(numlumps, sizeof *lumplocks);
+  wadimage = calloc(numwadfiles, sizeof *wadimage);
+  if (!lumplocks || !wadimage)
+    I_Error("W_InitCache: Couldn't allocate lump cache");
+
+  for (i=0; i<numwadfiles; i++)
+  {
+    int length;
+
+    if (!wadfiles[i].handle)
+      continue;
+
+    length = I_Filelength(wadfiles[i].handle);
+    if (!(wadimage[i] = malloc(length)))
+      I_Error("W_InitCache: Couldn't allocate %d bytes for %s",
+              length, wadfiles[i].name);
+
+    fseek(wadfiles[i].handle, 0, _SEEK_START);
+    I_Read(wadfiles[i].handle, wadimage[i], length);
+    lprintf(LO_INFO, "W_InitCache: %s loaded (%d bytes)\n",
+            wadfiles[i].name, length);
+  }
+}
+
+void W_DoneCache(void)
+{
+  size_t i;
+
+  if (wadimage)
+  {
+    for (i=0; i<numwadfiles; i++)
+      free(wadimage[i]);
+    free(wadimage);
+    wadimage = NULL;
+  }
+  free(lumplocks);
+  lumplocks = NULL;
+}
+
+const void *W_CacheLumpNum(int lump)
+{
+#ifdef RANGECHECK
+  if ((unsigned)lump >= (unsigned)numlumps)
+    I_Error ("W_CacheLumpNum: %i >= numlumps",lump);
+#endif
+  if (!lumpinfo[lump].wadfile)
+    return NULL;
+
+  lumplocks[lump]++;
+  W_CacheHits++;
+  return wadimage[lumpinfo[lump].wadfile-wadfiles] + lumpinfo[lump].position;
+}
+
+const void *W_LockLumpNum(int lump)
+{
+  return W_CacheLumpNum(lump);
+}
+
+// Everything is resident already, there is nothing to prefetch, evict
+// or load in the background
+
+void W_PrefetchLumps(const int *lumps, int count)
+{
+}
+
+boolean W_EvictLump(void)
+{
+  return false;
+}
+
+void W_QueueLumps(const int *lumps, int count)
+{
+}
+
+void W_ServiceQueue(void)
+{
+}
+
+void W_UnlockLumpNum(int lump)
+{
+#ifdef SIMPLECHECKS
+  if (lumplocks[lump] <= 0)
+    lprintf(LO_DEBUG, "W_UnlockLumpNum: Excess unlocks on %8s\n",
+      lumpinfo[lump].name);
+#endif
+  lumplocks[lump]--;
+}
@@ -46,6 +46,7 @@
 #include "w_wad.h"
 #include "z_zone.h"
 #include "lprintf.h"
+#include "i_system.h"
 
 static struct {
   void *cache;
@@ -53,8 +54,112 @@ static struct {
   int locktic;
 #endif
   unsigned int locks;
+  int size;                   // bytes charged to the cache, 0 if not cached
+  unsigned int lastuse;       // cacheclock when last cached or prefetched
+  int lruprev, lrunext;       // LRU list links, LRU_NONE if not on it
+  boolean queued;             // waiting in the load queue
 } *cachelump;
 
+// Unlocked lumps are kept on a list, most recently used first, and are
+// evicted from its tail when the cache goes over lumpcache_budget or
+// the zone runs out of memory. The zone may still purge every PU_CACHE
+// block as a last resort, so a listed lump whose cache pointer has been
+// cleared behind our back is just unlinked when found.
+
+#define LRU_NONE (-1)
+
+static int lruhead = LRU_NONE, lrutail = LRU_NONE;
+static size_t cachedbytes;
+static unsigned int cacheclock;
+static unsigned int evictions;
+
+// Background load queue. There are no threads to read lumps on, so the
+// queue is drained a slice at a time from the main loop instead, between
+// frames. A lump needed before its turn is simply read on demand.
+
+#define QUEUE_SLICE_MS 4  // reading time per W_ServiceQueue call
+
+static struct {
+  int lump;
+  unsigned int time;          // I_GetTime_MS when queued
+} *loadqueue;
+static int queuehead, queuecount, queuesize;
+static unsigned int queueclock;  // cacheclock when the queue was last empty
+static unsigned int queueloads, queuestalls, queuewait, queuemaxwait;
+
+static void W_LRUUnlink(int lump)
+{
+  int prev = cachelump[lump].lruprev, next = cachelump[lump].lrunext;
+
+  if (prev != LRU_NONE)
+    cachelump[prev].lrunext = next;
+  else if (lruhead == lump)
+    lruhead = next;
+  else
+    return;  // not on the list
+
+  if (next != LRU_NONE)
+    cachelump[next].lruprev = prev;
+  else
+    lrutail = prev;
+
+  cachelump[lump].lruprev = cachelump[lump].lrunext = LRU_NONE;
+}
+
+static void W_LRUPush(int lump)
+{
+  cachelump[lump].lruprev = LRU_NONE;
+  cachelump[lump].lrunext = lruhead;
+  if (lruhead != LRU_NONE)
+    cachelump[lruhead].lruprev = lump;
+  else
+    lrutail = lump;
+  lruhead = lump;
+}
+
+// Forgets an unlocked lump, freeing it unless the zone already did
+static void W_DropLump(int lump)
+{
+  W_LRUUnlink(lump);
+  cachedbytes -= cachelump[lump].size;
+  cachelump[lump].size = 0;
+  if (cachelump[lump].cache)
+    Z_Free(cachelump[lump].cache);
+}
+
+/* W_EvictLump
+ * Frees the least recently used unlocked lump, returns false if there
+ * is none.
+ */
+boolean W_EvictLump(void)
+{
+  if (lrutail == LRU_NONE)
+    return false;
+  W_DropLump(lrutail);
+  evictions++;
+  return true;
+}
+
+static void W_ReadCacheLump(int lump)
+{
+  const int len = W_LumpLength(lump);
+
+  if (cachelump[lump].size)  // purged by the zone while unlocked
+    W_DropLump(lump);
+
+  // make room first, so the zone does not have to
+  if (lumpcache_budget)
+    while (cachedbytes + len > (size_t)lumpcache_budget*1024 && W_EvictLump())
+      ;
+
+  W_ReadLump(lump, Z_Malloc(len, PU_CACHE, &cachelump[lump].cache));
+  if (cachelump[lump].cache)
+  {
+    cachelump[lump].size = len;
+    cachedbytes += len;
+  }
+}
+
 #ifdef HEAPDUMP
 void W_PrintLump(FILE* fp, void* p) {
   int i;
@@ -88,9 +193,13 @@ static void W_ReportLocks(void)
 void W_InitCache(void)
 {
   // set up caching
+  int i;
+
   cachelump = calloc(sizeof *cachelump, numlumps);
   if (!cachelump)
     I_Error ("W_Init: Couldn't allocate lumpcache");
+  for (i=0; i<numlumps; i++)
+    cachelump[i].lruprev = cachelump[i].lrunext = LRU_NONE;
 
 #ifdef TIMEDIAG
   atexit(W_ReportLocks);
@@ -116,11 +225,23 @@ const void *W_CacheLumpNum(int lump)
 #endif
 
   if (!cachelump[lump].cache)      // read the lump in
-    W_ReadLump(lump, Z_Malloc(W_LumpLength(lump), PU_CACHE, &cachelump[lump].cache));
+  {
+    if (cachelump[lump].queued)    // wanted before the queue got to it
+    {
+      cachelump[lump].queued = false;
+      queuestalls++;
+    }
+    W_ReadCacheLump(lump);
+    W_CacheMisses++;
+  }
+  else
+    W_CacheHits++;
+  cachelump[lump].lastuse = cacheclock++;
 
   /* cph - if wasn't locked but now is, tell z_zone to hold it */
   if (!cachelump[lump].locks && locks) {
     Z_ChangeTag(cachelump[lump].cache,PU_STATIC);
+    W_LRUUnlink(lump);
 #ifdef TIMEDIAG
     cachelump[lump].locktic = gametic;
 #endif
@@ -159,7 +280,166 @@ void W_UnlockLumpNum(int lump)
   /* cph - Note: must only tell z_zone to make purgeable if currently locked,
    * else it might already have been purged
    */
-  if (unlocks && !cachelump[lump].locks)
+  if (unlocks && !cachelump[lump].locks && cachelump[lump].cache)
+  {
     Z_ChangeTag(cachelump[lump].cache, PU_CACHE);
+    W_LRUPush(lump);
+
+    // unlocking is the first chance to trim a cache that went over
+    // budget while lumps were locked
+    if (lumpcache_budget)
+      while (cachedbytes > (size_t)lumpcache_budget*1024 && W_EvictLump())
+        ;
+  }
+}
+
+/* W_DropQueue
+ * Forgets the lumps the last level left in the load queue, and its stats
+ */
+static void W_DropQueue(void)
+{
+  for (; queuehead < queuecount; queuehead++)
+    cachelump[loadqueue[queuehead].lump].queued = false;
+  queuehead = queuecount = 0;
+  queueloads = queuestalls = queuewait = queuemaxwait = 0;
+}
+
+/* W_PrefetchLumps
+ * Reads in the given lumps ahead of use, unlocked, in order. With a
+ * budget set, lumps not used since the prefetch started may be evicted
+ * to make room, but the prefetched lumps themselves never are; lumps
+ * that do not fit are skipped.
+ */
+void W_PrefetchLumps(const int *lumps, int count)
+{
+  const unsigned int start = cacheclock;
+  const size_t budget = (size_t)lumpcache_budget*1024;
+  int i, read = 0, skipped = 0;
+
+  W_DropQueue();
+
+  for (i=0; i<count; i++)
+  {
+    const int lump = lumps[i];
+
+    if (cachelump[lump].cache)  // already in, just keep it
+    {
+      cachelump[lump].lastuse = cacheclock++;
+      if (!cachelump[lump].locks)
+      {
+        W_LRUUnlink(lump);
+        W_LRUPush(lump);
+      }
+      continue;
+    }
+
+    if (budget)
+    {
+      const int len = W_LumpLength(lump);
+
+      while (cachedbytes + len > budget && lrutail != LRU_NONE &&
+             cachelump[lrutail].lastuse < start)
+        W_EvictLump();
+      if (cachedbytes + len > budget)
+      {
+        skipped++;
+        continue;
+      }
+    }
+
+    W_ReadCacheLump(lump);
+    if (cachelump[lump].cache)
+    {
+      cachelump[lump].lastuse = cacheclock++;
+      W_LRUPush(lump);
+      read++;
+    }
+  }
+
+  lprintf(LO_INFO, "W_PrefetchLumps: %d of %d lumps read, %d over budget, "
+          "%uk cached, %u evictions so far\n",
+          read, count, skipped, (unsigned)(cachedbytes / 1024), evictions);
 }
 
+/* W_QueueLumps
+ * Replaces the background load queue with the lumps of a new level,
+ * see W_ServiceQueue
+ */
+void W_QueueLumps(const int *lumps, int count)
+{
+  const unsigned int now = I_GetTime_MS();
+  int i;
+
+  W_DropQueue();
+  queueclock = cacheclock;
+  if (count > queuesize)
+    loadqueue = realloc(loadqueue, (queuesize = count) * sizeof *loadqueue);
+
+  for (i=0; i<count; i++)
+    if (!cachelump[lumps[i]].cache && !cachelump[lumps[i]].queued)
+    {
+      cachelump[lumps[i]].queued = true;
+      loadqueue[queuecount].lump = lumps[i];
+      loadqueue[queuecount++].time = now;
+    }
+}
+
+/* W_ServiceQueue
+ * Reads queued lumps for up to QUEUE_SLICE_MS, at least one per call.
+ * Queued lumps are read unlocked and, like prefetched ones, may only
+ * evict lumps not used since they were queued, else they are skipped.
+ */
+void W_ServiceQueue(void)
+{
+  const unsigned int start = I_GetTime_MS();
+  const size_t budget = (size_t)lumpcache_budget*1024;
+
+  if (queuehead == queuecount)
+    return;
+
+  do
+  {
+    const int lump = loadqueue[queuehead].lump;
+    const unsigned int wait = start - loadqueue[queuehead].time;
+
+    queuehead++;
+    if (!cachelump[lump].queued)  // already read on demand
+      continue;
+    cachelump[lump].queued = false;
+    if (cachelump[lump].cache)    // or prefetched meanwhile
+      continue;
+
+    if (budget)
+    {
+      const int len = W_LumpLength(lump);
+
+      while (cachedbytes + len > budget && lrutail != LRU_NONE &&
+             cachelump[lrutail].lastuse < queueclock)
+        W_EvictLump();
+      if (cachedbytes + len > budget)
+        continue;
+    }
+
+    W_ReadCacheLump(lump);
+    if (cachelump[lump].cache)
+    {
+      cachelump[lump].lastuse = cacheclock++;
+      W_LRUPush(lump);
+    }
+
+    queueloads++;
+    queuewait += wait;
+    if (wait > queuemaxwait)
+      queuemaxwait = wait;
+  } while (queuehead < queuecount && I_GetTime_MS() - start < QUEUE_SLICE_MS);
+
+  if (queuehead == queuecount)
+  {
+    lprintf(LO_INFO, "W_ServiceQueue: %u lumps loaded, waited %ums on average, "
+            "%ums at most, %u needed before loaded\n",
+            queueloads, queueloads ? queuewait / queueloads : 0, queuemaxwait,
+            queuestalls);
+    queuehead = queuecount = 0;
+    queueloads = queuestalls = queuewait = queuemaxwait = 0;
+  }
+}
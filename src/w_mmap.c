@@ -331,3 +331,23 @@ void W_UnlockLumpNum(int lump) {
     Z_ChangeTag(cachelump[lump].cache, PU_CACHE);
 }
 
+
+// Lumps are mapped, there is nothing to prefetch or load in the
+// background, and the locked copies are left to the zone
+
+void W_PrefetchLumps(const int *lumps, int count)
+{
+}
+
+boolean W_EvictLump(void)
+{
+  return false;
+}
+
+void W_QueueLumps(const int *lumps, int count)
+{
+}
+
+void W_ServiceQueue(void)
+{
+}
@@ -65,6 +65,9 @@
 lumpinfo_t *lumpinfo;
 int        numlumps;         // killough
 
+unsigned int W_CacheHits, W_CacheMisses;
+int lumpcache_budget;
+
 void ExtractFileBase (const char *path, char *dest)
 {
   const char *src = path + strlen(path) - 1;
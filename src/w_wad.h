@@ -133,6 +133,20 @@ const void* W_CacheLumpNum (int lump);
 const void* W_LockLumpNum(int lump);
 void    W_UnlockLumpNum(int lump);
 
+// W_CacheLumpNum calls served from memory and calls that had to read
+extern unsigned int W_CacheHits, W_CacheMisses;
+
+// Most kilobytes of unlocked lumps to keep cached, 0 for no limit
+extern int lumpcache_budget;
+
+// Reads lumps in ahead of use, as far as the budget allows
+void    W_PrefetchLumps(const int *lumps, int count);
+// Frees the least recently used unlocked lump, false if there is none
+boolean W_EvictLump(void);
+// Replaces the lumps queued to be read between frames by W_ServiceQueue
+void    W_QueueLumps(const int *lumps, int count);
+void    W_ServiceQueue(void);
+
 // CPhipps - convenience macros
 //#define W_CacheLumpNum(num) (W_CacheLumpNum)((num),1)
 #define W_CacheLumpName(name) W_CacheLumpNum (W_GetNumForName(name))
@@ -44,81 +44,78 @@
 typedef struct bmalpool_s {
   struct bmalpool_s *nextpool;
   size_t             blocks;
-  byte               used[0];
 } bmalpool_t;
 
-inline static void* getelem(bmalpool_t *p, size_t size, size_t n)
-{
-  return (((byte*)p) + sizeof(bmalpool_t) + sizeof(byte)*(p->blocks) + size*n);
-}
+// Elements start on the first cache line after the pool header
+#define BMALPOOL_HEADER BMALLOC_ALIGN(sizeof(bmalpool_t))
 
-inline static PUREFUNC int iselem(const bmalpool_t *pool, size_t size, const void* p)
+inline static void* getelem(bmalpool_t *p, size_t size, size_t n)
 {
-  // CPhipps - need portable # of bytes between pointers
-  int dif = (const char*)p - (const char*)pool;
-
-  dif -= sizeof(bmalpool_t);
-  dif -= pool->blocks;
-  if (dif<0) return -1;
-  dif /= size;
-  return (((size_t)dif >= pool->blocks) ? -1 : dif);
+  return (((byte*)p) + BMALPOOL_HEADER + size*n);
 }
 
-enum { unused_block = 0, used_block = 1};
-
 void* Z_BMalloc(struct block_memory_alloc_s *pzone)
 {
-  register bmalpool_t **pool = (bmalpool_t **)&(pzone->firstpool);
-  while (*pool != NULL) {
-    byte *p = (byte *)memchr((*pool)->used, unused_block, (*pool)->blocks); // Scan for unused marker
-    if (p) {
-      int n = p - (*pool)->used;
-#ifdef SIMPLECHECKS
-      if ((n<0) || ((size_t)n>=(*pool)->blocks))
-  I_Error("Z_BMalloc: memchr returned pointer outside of array");
-#endif
-      (*pool)->used[n] = used_block;
-      return getelem(*pool, pzone->size, n);
-    } else
-      pool = &((*pool)->nextpool);
-  }
-  {
-    // Nothing available, must allocate a new pool
-    bmalpool_t *newpool;
-
-    // CPhipps: Allocate new memory, initialised to 0
+  void *p;
 
-    *pool = newpool = (bmalpool_t *)Z_Calloc(sizeof(*newpool) + (sizeof(byte) + pzone->size)*(pzone->perpool),
-             1,  pzone->tag, NULL);
-    newpool->nextpool = NULL; // NULL = (void*)0 so this is redundant
+  if (!pzone->freelist) {
+    // Nothing available, must allocate a new pool and thread its
+    // elements onto the free list, first element first
+    bmalpool_t *newpool;
+    size_t n;
 
-    // Return element 0 from this pool to satisfy the request
-    newpool->used[0] = used_block;
+    // Z_Malloc only aligns to CHUNK_SIZE, so ask for a line more and
+    // start the pool on a line boundary. Pools only go with their tag,
+    // nothing needs the address Z_Malloc returned.
+    newpool = (bmalpool_t *)Z_Malloc(BMALLOC_LINE - 1 + BMALPOOL_HEADER +
+             pzone->size*pzone->perpool, pzone->tag, NULL);
+    newpool = (bmalpool_t *)(((size_t)newpool + BMALLOC_LINE - 1) &
+                             ~(size_t)(BMALLOC_LINE - 1));
+    newpool->nextpool = pzone->firstpool;
     newpool->blocks = pzone->perpool;
-    return getelem(newpool, pzone->size, 0);
+    pzone->firstpool = newpool;
+    pzone->pools++;
+
+    for (n = newpool->blocks; n-- > 0; ) {
+      void **elem = getelem(newpool, pzone->size, n);
+      *elem = pzone->freelist;
+      pzone->freelist = elem;
+    }
   }
+
+  p = pzone->freelist;
+  pzone->freelist = *(void **)p;
+  if (++pzone->used > pzone->peak)
+    pzone->peak = pzone->used;
+  return p;
 }
 
 void Z_BFree(struct block_memory_alloc_s *pzone, void* p)
 {
-  register bmalpool_t **pool = (bmalpool_t**)&(pzone->firstpool);
-
-  while (*pool != NULL) {
-    int n = iselem(*pool, pzone->size, p);
-    if (n >= 0) {
 #ifdef SIMPLECHECKS
-      if ((*pool)->used[n] == unused_block)
-  I_Error("Z_BFree: Refree in zone %s", pzone->desc);
+  if (!Z_BIsElem(pzone, p))
+    I_Error("Z_BFree: Free not in zone %s", pzone->desc);
 #endif
-      (*pool)->used[n] = unused_block;
-      if (memchr(((*pool)->used), used_block, (*pool)->blocks) == NULL) {
-  // Block is all unused, can be freed
-  bmalpool_t *oldpool = *pool;
-  *pool = (*pool)->nextpool;
-  Z_Free(oldpool);
-      }
-      return;
-    } else pool = &((*pool)->nextpool);
+  *(void **)p = pzone->freelist;
+  pzone->freelist = p;
+  pzone->used--;
+}
+
+boolean Z_BIsElem(const struct block_memory_alloc_s *pzone, const void* p)
+{
+  const bmalpool_t *pool;
+
+  for (pool = pzone->firstpool; pool; pool = pool->nextpool) {
+    const byte *first = getelem((bmalpool_t *)pool, pzone->size, 0);
+    if ((const byte *)p >= first && (const byte *)p < first + pzone->size*pool->blocks)
+      return true;
   }
-  I_Error("Z_BFree: Free not in zone %s", pzone->desc);
+  return false;
+}
+
+void Z_BLogStats(const struct block_memory_alloc_s *pzone)
+{
+  if (pzone->pools)
+    lprintf(LO_INFO, "Z_BLogStats: %s peak %d of %d in %d pools\n", pzone->desc,
+            pzone->peak, pzone->pools * (int)pzone->perpool, pzone->pools);
 }
@@ -31,6 +31,10 @@
  *  This is designed to be a fast allocator for small, regularly used block sizes
  *-----------------------------------------------------------------------------*/
 
+#ifndef __Z_BMALLOC__
+#define __Z_BMALLOC__
+
+#include "doomtype.h"
 #include "brew.h"
 
 #if defined(_MSC_VER) && !defined(__cplusplus)
@@ -39,16 +43,27 @@
 
 struct block_memory_alloc_s {
   void  *firstpool;
+  void  *freelist;  // free elements, linked through their first word
   size_t size;
   size_t perpool;
   int    tag;
   const char *desc;
+  int    used, peak, pools;
 };
 
+// Elements are rounded up to whole cache lines, so no element straddles
+// more lines than it has to and neighbours never share one
+#define BMALLOC_LINE 32
+#define BMALLOC_ALIGN(size) (((size)+BMALLOC_LINE-1) & ~(BMALLOC_LINE-1))
+
 #define DECLARE_BLOCK_MEMORY_ALLOC_ZONE(name) extern struct block_memory_alloc_s name
 #define IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(name, size, tag, num, desc) \
-struct block_memory_alloc_s name = { NULL, size, num, tag, desc}
-#define NULL_BLOCK_MEMORY_ALLOC_ZONE(name) name.firstpool = NULL
+struct block_memory_alloc_s name = { NULL, NULL, BMALLOC_ALIGN(size), num, tag, desc}
+
+// Pools are never released while in use, only with their zone tag by
+// Z_FreeTags, after which the zone must be reset with this
+#define NULL_BLOCK_MEMORY_ALLOC_ZONE(name) \
+  (name.firstpool = name.freelist = NULL, name.used = name.peak = name.pools = 0)
 
 void* Z_BMalloc(struct block_memory_alloc_s *pzone);
 
@@ -56,3 +71,11 @@ inline static void* Z_BCalloc(struct block_memory_alloc_s *pzone)
 { void *p = Z_BMalloc(pzone); memset(p,0,pzone->size); return p; }
 
 void Z_BFree(struct block_memory_alloc_s *pzone, void* p);
+
+// Returns true if p is an element of one of the zone's pools
+boolean Z_BIsElem(const struct block_memory_alloc_s *pzone, const void* p);
+
+// Logs the zone's high-water mark since it was last reset
+void Z_BLogStats(const struct block_memory_alloc_s *pzone);
+
+#endif
@@ -52,6 +52,7 @@
 #include "v_video.h"
 #include "g_game.h"
 #include "lprintf.h"
+#include "w_wad.h"
 #include "brew.h"
 
 #ifdef DJGPP
@@ -81,6 +82,14 @@
 // Number of mallocs & frees kept in history buffer (must be a power of 2)
 #define ZONE_HISTORY 4
 
+// Blocks of up to SLAB_CLASSES*CHUNK_SIZE bytes come from slab pages of
+// SLAB_PAGE_SIZE bytes, one size class per CHUNK_SIZE step
+#define SLAB_CLASSES 8
+#define SLAB_PAGE_SIZE (16*1024)
+
+// sizeclass of blocks carved from the level arena
+#define ARENA_CLASS 0xff
+
 // End Tunables
 
 typedef struct memblock {
@@ -93,6 +102,8 @@ typedef struct memblock {
   size_t size;
   void **user;
   unsigned char tag;
+  unsigned char sizeclass;    // slab class + 1, 0 if BREW_malloc'ed,
+                              // ARENA_CLASS if from the level arena
 
 #ifdef INSTRUMENTED
   const char *file;
@@ -108,6 +119,52 @@ static const size_t HEADER_SIZE = (sizeof(memblock_t)+CHUNK_SIZE-1) & ~(CHUNK_SI
 
 static memblock_t *blockbytag[PU_MAX];
 
+// Small blocks are carved from slab pages and kept on a free list per
+// size class when freed, so allocating and freeing them is O(1) and the
+// BREW heap only ever sees slab pages and large blocks. Pages are kept
+// for reuse, until an allocation fails and Z_ReleaseSlabPages hands the
+// ones with no block in use back to the heap.
+
+static memblock_t *slabfree[SLAB_CLASSES];
+
+typedef struct {
+  char *base;
+  int free;    // only valid inside Z_ReleaseSlabPages
+} slabpage_t;
+
+static slabpage_t *slabpages[SLAB_CLASSES];  // sorted by base
+static int slabpagecap[SLAB_CLASSES];
+
+static struct {
+  int pages;   // slab pages carved for this class
+  int used;    // blocks currently handed out
+  int peak;    // most blocks handed out at once
+} slabstats[SLAB_CLASSES];
+
+static int large_blocks, large_bytes;  // blocks straight from BREW_malloc
+
+zonestats_t zonestats;
+
+// Counts bytes taken from (n > 0) or given back to the BREW heap
+static void Z_Footprint(int n)
+{
+  zonestats.footprint += n;
+  if (zonestats.footprint > zonestats.peakfootprint)
+    zonestats.peakfootprint = zonestats.footprint;
+}
+
+// While a level loads, PU_LEVEL and PU_LEVSPEC blocks are bumped out of
+// one arena sized for the map, so its data is contiguous and does not
+// fragment the heap. Blocks stay on the tag lists as usual; freeing one
+// only counts it, and once none are left the arena is rewound and kept
+// for the next level. Allocations that do not fit fall back to the
+// normal path.
+
+static char *arena;
+static size_t arena_size, arena_used;
+static int arena_live;       // arena blocks not yet freed
+static boolean arena_active; // between Z_BeginLevelArena and Z_EndLevelArena
+
 // 0 means unlimited, any other value is a hard limit
 //static int memory_size = 8192*1024;
 static int memory_size = 0;
@@ -317,6 +374,228 @@ void Z_Init(void)
 #endif
 }
 
+static memblock_t *Z_AllocBlock(size_t size)
+{
+  memblock_t *block;
+  int c;
+
+  if (size > SLAB_CLASSES*CHUNK_SIZE)
+  {
+    if ((block = (memblock_t *)BREW_malloc(size + HEADER_SIZE)) != NULL)
+    {
+      block->sizeclass = 0;
+      large_blocks++;
+      large_bytes += size;
+      Z_Footprint(size + HEADER_SIZE);
+    }
+    return block;
+  }
+
+  c = size / CHUNK_SIZE - 1;
+
+  if (!slabfree[c])
+  {
+    const size_t blocksize = HEADER_SIZE + size;
+    char *page = BREW_malloc(SLAB_PAGE_SIZE);
+    int i;
+
+    if (!page)
+      return NULL;
+
+    if (slabstats[c].pages == slabpagecap[c])
+    {
+      // realloc is Z_Realloc in here, grow the page table by hand
+      int cap = slabpagecap[c] ? slabpagecap[c]*2 : 16;
+      slabpage_t *pages = BREW_malloc(cap * sizeof *pages);
+
+      if (!pages)
+      {
+        BREW_free(page);
+        return NULL;
+      }
+      if (slabpages[c])
+      {
+        memcpy(pages, slabpages[c], slabstats[c].pages * sizeof *pages);
+        BREW_free(slabpages[c]);
+      }
+      slabpages[c] = pages;
+      slabpagecap[c] = cap;
+    }
+    for (i = slabstats[c].pages; i > 0 && slabpages[c][i-1].base > page; i--)
+      slabpages[c][i] = slabpages[c][i-1];
+    slabpages[c][i].base = page;
+
+    for (i = SLAB_PAGE_SIZE / blocksize - 1; i >= 0; i--)
+    {
+      block = (memblock_t *)(page + i * blocksize);
+      block->next = slabfree[c];
+      slabfree[c] = block;
+    }
+    slabstats[c].pages++;
+    Z_Footprint(SLAB_PAGE_SIZE);
+  }
+
+  block = slabfree[c];
+  slabfree[c] = block->next;
+  block->sizeclass = c + 1;
+
+  if (++slabstats[c].used > slabstats[c].peak)
+    slabstats[c].peak = slabstats[c].used;
+
+  return block;
+}
+
+static void Z_FreeBlock(memblock_t *block, int sizeclass, size_t size)
+{
+  if (sizeclass == ARENA_CLASS)
+  {
+    if (!--arena_live && !arena_active)
+      arena_used = 0;
+    return;
+  }
+
+  if (!sizeclass)
+  {
+    large_blocks--;
+    large_bytes -= size;
+    Z_Footprint(-(int)(size + HEADER_SIZE));
+    BREW_free(block);
+    return;
+  }
+
+  block->next = slabfree[sizeclass - 1];
+  slabfree[sizeclass - 1] = block;
+  slabstats[sizeclass - 1].used--;
+}
+
+static slabpage_t *Z_SlabPage(int c, const memblock_t *block)
+{
+  int lo = 0, hi = slabstats[c].pages - 1;
+
+  while (lo < hi)
+  {
+    int mid = (lo + hi + 1) / 2;
+
+    if (slabpages[c][mid].base <= (const char *)block)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return &slabpages[c][lo];
+}
+
+//
+// Z_ReleaseSlabPages
+// Gives the slab pages none of whose blocks are in use back to the BREW
+// heap, so a large block can be allocated from the space. Returns the
+// number of pages released.
+//
+static int Z_ReleaseSlabPages(void)
+{
+  int c, released = 0;
+
+  for (c = 0; c < SLAB_CLASSES; c++)
+  {
+    const int perpage = SLAB_PAGE_SIZE / (HEADER_SIZE + (c + 1) * CHUNK_SIZE);
+    memblock_t **link, *block;
+    int i, kept;
+
+    if (slabstats[c].used > (slabstats[c].pages - 1) * perpage)
+      continue;   // not a single page can be empty
+
+    for (i = 0; i < slabstats[c].pages; i++)
+      slabpages[c][i].free = 0;
+    for (block = slabfree[c]; block; block = block->next)
+      Z_SlabPage(c, block)->free++;
+
+    // unlink the blocks of the empty pages, then drop the pages
+    for (link = &slabfree[c]; (block = *link) != NULL; )
+      if (Z_SlabPage(c, block)->free == perpage)
+        *link = block->next;
+      else
+        link = &block->next;
+
+    for (i = kept = 0; i < slabstats[c].pages; i++)
+      if (slabpages[c][i].free == perpage)
+      {
+        BREW_free(slabpages[c][i].base);
+        Z_Footprint(-SLAB_PAGE_SIZE);
+        released++;
+      }
+      else
+        slabpages[c][kept++] = slabpages[c][i];
+    slabstats[c].pages = kept;
+  }
+  return released;
+}
+
+//
+// Z_BeginLevelArena
+// Serves level tagged blocks from an arena of at least size bytes until
+// Z_EndLevelArena. Must be called after the previous level was freed.
+//
+void Z_BeginLevelArena(size_t size)
+{
+  if (arena_live)
+  {
+    lprintf(LO_WARN, "Z_BeginLevelArena: %d blocks of the last level still in use\n",
+            arena_live);
+    return;
+  }
+
+  arena_used = 0;
+  if (size > arena_size)
+  {
+    BREW_free(arena);
+    Z_Footprint(-(int)arena_size);
+    if (!(arena = BREW_malloc(size)))
+    {
+      arena_size = 0;
+      return;
+    }
+    arena_size = size;
+    Z_Footprint(size);
+  }
+  arena_active = true;
+}
+
+void Z_EndLevelArena(void)
+{
+  if (!arena_active)
+    return;
+
+  arena_active = false;
+  lprintf(LO_INFO, "Z_EndLevelArena: %dk of %dk used by %d blocks\n",
+          (int)(arena_used / 1024), (int)(arena_size / 1024), arena_live);
+  if (!arena_live)
+    arena_used = 0;
+}
+
+//
+// Z_LogStats
+// Reports how the slabs and the BREW heap are used
+//
+void Z_LogStats(void)
+{
+  int c, pages = 0, used = 0;
+
+  for (c = 0; c < SLAB_CLASSES; c++)
+  {
+    const int perpage = SLAB_PAGE_SIZE / (HEADER_SIZE + (c + 1) * CHUNK_SIZE);
+
+    pages += slabstats[c].pages;
+    used += slabstats[c].used * (HEADER_SIZE + (c + 1) * CHUNK_SIZE);
+    if (slabstats[c].pages)
+      lprintf(LO_DEBUG, "Z_LogStats: %4d byte blocks: %d pages, %d of %d used, peak %d\n",
+              (c + 1) * CHUNK_SIZE, slabstats[c].pages, slabstats[c].used,
+              slabstats[c].pages * perpage, slabstats[c].peak);
+  }
+
+  lprintf(LO_INFO, "Z_LogStats: slabs %dk of %dk used, %d large blocks %dk, %d cache purges\n",
+          used / 1024, pages * SLAB_PAGE_SIZE / 1024,
+          large_blocks, large_bytes / 1024, zonestats.cachepurges);
+}
+
 /* Z_Malloc
  * You can pass a NULL user if the tag is < PU_PURGELEVEL.
  *
@@ -384,18 +663,40 @@ void *(Z_Malloc)(size_t size, int tag, void **user
     block = NULL;
   }
 
+#ifndef HAVE_LIBDMALLOC
+  if (arena_active && (tag == PU_LEVEL || tag == PU_LEVSPEC) &&
+      arena_used + HEADER_SIZE + size <= arena_size)
+  {
+    block = (memblock_t *)(arena + arena_used);
+    block->sizeclass = ARENA_CLASS;
+    arena_used += HEADER_SIZE + size;
+    arena_live++;
+  }
+  else
+#endif
 #ifdef HAVE_LIBDMALLOC
   while (!(block = dmalloc_malloc(file,line,size + HEADER_SIZE,DMALLOC_FUNC_MALLOC,0,0))) {
 #else
-  while (!(block = (memblock_t *)BREW_malloc(size + HEADER_SIZE))) {
+  while (!(block = Z_AllocBlock(size))) {
 #endif
+    // give back the least recently used lumps first, and only flush
+    // the whole cache once there are none left
+    if (W_EvictLump())
+      continue;
     if (!blockbytag[PU_CACHE])
+    {
+      // the freed blocks may have emptied whole slab pages
+      if (Z_ReleaseSlabPages())
+        continue;
 #ifdef INSTRUMENTED
       I_Error ("Z_Malloc: F %lu %s:%d",(unsigned long) size, file, line);
 #else
 	  I_Error ("Z_Malloc: F %lu",(unsigned long) size);
 #endif
+    }
     Z_FreeTags(PU_CACHE,PU_CACHE);
+    Z_ReleaseSlabPages();
+    zonestats.cachepurges++;
   }
 
   if (!blockbytag[tag])
@@ -412,6 +713,8 @@ void *(Z_Malloc)(size_t size, int tag, void **user
   }
     
   block->size = size;
+  zonestats.tagbytes[tag] += size;
+  zonestats.allocs++;
 
 #ifdef INSTRUMENTED
   if (tag >= PU_PURGELEVEL)
@@ -451,6 +754,8 @@ void (Z_Free)(void *p
              )
 {
   memblock_t *block = (memblock_t *)((char *) p - HEADER_SIZE);
+  int sizeclass;
+  size_t size;
 
 #ifdef INSTRUMENTED
 #ifdef CHECKHEAP
@@ -489,6 +794,10 @@ void (Z_Free)(void *p
   block->next->prev = block->prev;
 
   free_memory += block->size;
+  zonestats.tagbytes[block->tag] -= block->size;
+  zonestats.frees++;
+  sizeclass = block->sizeclass;
+  size = block->size;
 #ifdef INSTRUMENTED
   if (block->tag >= PU_PURGELEVEL)
     purgable_memory -= block->size;
@@ -502,7 +811,7 @@ void (Z_Free)(void *p
 #ifdef HAVE_LIBDMALLOC
   dmalloc_free(file,line,block,DMALLOC_FUNC_MALLOC);
 #else
-  BREW_free(block);
+  Z_FreeBlock(block, sizeclass, size);
 #endif
 #ifdef INSTRUMENTED
       Z_DrawStats();           // print memory allocation stats
@@ -611,6 +920,9 @@ void (Z_ChangeTag)(void *ptr, int tag
     blockbytag[tag]->prev = block;
   }
 
+  zonestats.tagbytes[block->tag] -= block->size;
+  zonestats.tagbytes[tag] += block->size;
+
 #ifdef INSTRUMENTED
   if (block->tag < PU_PURGELEVEL && tag >= PU_PURGELEVEL)
   {
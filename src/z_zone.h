@@ -78,6 +78,20 @@ void *(Z_Realloc)(void *p, size_t n, int tag, void **user DA(const char *, int))
 char *(Z_Strdup)(const char *s, int tag, void **user DA(const char *, int));
 void (Z_CheckHeap)(DAC(const char *,int));   // killough 3/22/98: add file/line info
 void Z_DumpHistory(char *);
+void Z_LogStats(void);
+void Z_BeginLevelArena(size_t size);
+void Z_EndLevelArena(void);
+
+// Heap figures kept in every build, for m_memstats.c
+typedef struct {
+  size_t tagbytes[PU_MAX];     // bytes in blocks of each tag, headers excluded
+  unsigned int allocs, frees;  // Z_Malloc and Z_Free calls so far
+  size_t footprint;            // bytes currently taken from the BREW heap
+  size_t peakfootprint;
+  int cachepurges;             // PU_CACHE flushes on a failed allocation
+} zonestats_t;
+
+extern zonestats_t zonestats;
 
 #ifdef INSTRUMENTED
 /* cph - save space if not debugging, don't require file 